@@ -0,0 +1,95 @@
+#include "maindefs.h"
+#ifndef __XC8
+#include <timers.h>
+#else
+#include <plib/timers.h>
+#endif
+#include "my_uart.h"
+#include "binlog.h"
+
+#if defined(BINARY_LOG) && defined(MOTORPIC)
+#error "BINARY_LOG records would be mixed in with the movement commands to the motor controller"
+#endif
+
+#ifdef BINARY_LOG
+
+typedef struct __log_record {
+    unsigned char event;
+    unsigned char a;
+    unsigned char b;
+    unsigned int stamp;
+} log_record;
+
+// log_event() owns log_in and lost, and runs with GIEH clear because it
+// can be called from anywhere.  log_next() is only called by the UART
+// transmit handler and owns log_out and out_pos; the record at log_out is
+// not reused until all of it has been sent.
+static log_record ring[LOG_RECORDS];
+static unsigned char log_in;
+static unsigned char log_out;
+static unsigned char out_pos;
+static unsigned char lost;
+
+void init_binlog() {
+    log_in = 0;
+    log_out = 0;
+    out_pos = 0;
+    lost = 0;
+}
+
+void log_event(unsigned char event, unsigned char a, unsigned char b) {
+    unsigned char gieh = INTCONbits.GIEH;
+    unsigned char next;
+    log_record *rp;
+
+    INTCONbits.GIEH = 0;
+    next = (log_in + 1) % LOG_RECORDS;
+    if (next == log_out) {
+        if (lost < 0xFF) {
+            lost++;
+        }
+    } else {
+        if (lost) {
+            // this one goes in as the count of what didn't
+            b = event;
+            a = (lost < 0xFF) ? lost + 1 : lost;
+            event = LOG_LOST;
+            lost = 0;
+        }
+        rp = &ring[log_in];
+        rp->event = event;
+        rp->a = a;
+        rp->b = b;
+        rp->stamp = ReadTimer1();
+        log_in = next;
+        // get the transmit interrupt going if it isn't already
+        PIE1bits.TX1IE = 1;
+    }
+    INTCONbits.GIEH = gieh;
+}
+
+signed char log_next(unsigned char *buf) {
+    signed char length = 0;
+    log_record *rp;
+
+    while ((length < MAXUARTBUF) && (log_out != log_in)) {
+        rp = &ring[log_out];
+        switch (out_pos) {
+            case 0: buf[length] = LOG_SYNC; break;
+            case 1: buf[length] = rp->event; break;
+            case 2: buf[length] = rp->stamp & 0xFF; break;
+            case 3: buf[length] = rp->stamp >> 8; break;
+            case 4: buf[length] = rp->a; break;
+            default: buf[length] = rp->b; break;
+        }
+        length++;
+        out_pos++;
+        if (out_pos == LOG_RECLEN) {
+            out_pos = 0;
+            log_out = (log_out + 1) % LOG_RECORDS;
+        }
+    }
+    return (length);
+}
+
+#endif
@@ -0,0 +1,63 @@
+#ifndef __binlog_h
+#define __binlog_h
+
+// Binary event log (enabled with BINARY_LOG in maindefs.h)
+//
+// log_event() puts a fixed-size record in a ring and returns; the UART
+// transmit handler sends the records out when it has nothing else to send
+// (a capture dump goes first).  It is not for the motor PIC, whose UART
+// carries the movement commands to the motor controller.  It may be called
+// from main() and from either interrupt priority, and only masks
+// interrupts while it fills in the record.  When the ring is
+// full the event is counted instead, and the next one that fits is sent as
+// a LOG_LOST record.
+//
+// Counting the instructions a call needs by hand gives roughly 50
+// instruction cycles, about 4 us at Fcy = 12 MHz, with GIEH clear for about
+// 40 of them: the call and its three arguments (~9), saving and clearing
+// GIEH (~4), the next ring index (~4, if the % on the power-of-two
+// LOG_RECORDS becomes an AND), the full check (~5), indexing the five-byte
+// record (~6), the three argument bytes (~6), ReadTimer1() and the stamp
+// (~12), and the rest (~8).  That is an estimate, not a measurement -- it
+// has not been timed on the part, and the compiler in free mode can add a
+// good deal to it.
+//
+// On the UART each record is LOG_RECLEN bytes:
+//     LOG_SYNC, event, timer1 count (little-endian), first arg, second arg
+// tools/logdecode.c turns the stream back into text with the formats in
+// the table below (so this header must stay free of PIC-specific code).
+//
+//      event               format (for the two argument bytes)
+#define LOG_EVENTS \
+    LOG_EVENT(LOG_LOST,         "%u records lost, last event %u") \
+    LOG_EVENT(LOG_BOOT,         "boot, reset cause %u") \
+    LOG_EVENT(LOG_I2C_ERROR,    "i2c slave error %u in state %u") \
+    LOG_EVENT(LOG_UART_OVERRUN, "uart receive overrun") \
+    LOG_EVENT(LOG_UART_CRC,     "uart frame dropped, crc %u expected %u") \
+    LOG_EVENT(LOG_MOTOR_FULL,   "movement command %u dropped, queue full")
+
+#define LOG_EVENT(name, format) name,
+enum {
+    LOG_EVENTS
+    NUM_LOG_EVENTS
+};
+#undef LOG_EVENT
+
+#define LOG_SYNC 0xA5
+#define LOG_RECLEN 6
+#define LOG_RECORDS 16
+
+#ifdef BINARY_LOG
+void init_binlog(void);
+void log_event(unsigned char, unsigned char, unsigned char);
+// Called from the low priority (UART transmit) interrupt handler when it
+// has nothing else to send.  Copies the next part of the log into the
+// buffer and returns its length, or 0 if the ring is empty.
+signed char log_next(unsigned char *);
+#else
+#define init_binlog()
+#define log_event(event, a, b)
+#define log_next(buf) (0)
+#endif
+
+#endif
@@ -0,0 +1,152 @@
+#include "maindefs.h"
+#ifndef __XC8
+#include <timers.h>
+#else
+#include <plib/timers.h>
+#endif
+#include "my_uart.h"
+#include "busmon.h"
+
+#if defined(I2C_BUS_MONITOR) && defined(MOTORPIC)
+#error "I2C_BUS_MONITOR dumps would be mixed in with the movement commands to the motor controller"
+#endif
+#if defined(I2C_BUS_MONITOR) && defined(CLOCK_GOVERNOR)
+#error "CLOCK_GOVERNOR changes the timer1 rate the bus monitor times with"
+#endif
+
+#if defined(I2C_BUS_MONITOR) && defined(I2CMASTER)
+
+#define BUSMON_HEADERLEN 4
+
+// "live" is counted by the I2C handler (high priority) and the start of
+// each transaction by main(), which only starts one while the bus is
+// idle; busmon_tick() copies it out with GIEH clear.  "last" belongs to
+// the low priority handlers and main() reads it with GIEH clear.
+static busmon_stats live;
+static busmon_stats last;
+static unsigned int start;
+static unsigned char slave;
+static unsigned char window;
+static unsigned char dumping;
+static unsigned char dump_pos;
+
+static void busmon_clear(busmon_stats *sp) {
+    unsigned char *p = (unsigned char *) sp;
+    unsigned char i;
+
+    for (i = 0; i < sizeof (busmon_stats); i++) {
+        p[i] = 0;
+    }
+}
+
+void init_busmon() {
+    busmon_clear(&live);
+    busmon_clear(&last);
+    slave = BUSMON_OTHER;
+    window = 0;
+    dumping = 0;
+}
+
+void busmon_start(unsigned char addr) {
+    addr &= 0xFE;
+    slave = BUSMON_OTHER;
+#define BUSMON_SLAVE(name, a) \
+    if (addr == ((a) & 0xFE)) { \
+        slave = (name); \
+    }
+    BUSMON_SLAVES
+#undef BUSMON_SLAVE
+    start = ReadTimer1();
+}
+
+void busmon_retry() {
+    live.slaves[slave].nacks++;
+    live.slaves[slave].retries++;
+}
+
+void busmon_end(unsigned char failed, unsigned char bytes) {
+    unsigned int elapsed = ReadTimer1() - start;
+    unsigned char bucket;
+
+    live.transactions++;
+    live.slaves[slave].transactions++;
+    if (failed) {
+        live.failed++;
+        live.slaves[slave].nacks++;
+    }
+    live.bytes += bytes;
+    live.busy += elapsed;
+    if (elapsed > live.longest) {
+        live.longest = elapsed;
+    }
+    for (bucket = 0; elapsed != 0; bucket++) {
+        elapsed >>= 1;
+    }
+    live.hist[bucket]++;
+}
+
+void busmon_tick() {
+    unsigned char gieh;
+
+    if (++window < BUSMON_WINDOW) {
+        return;
+    }
+    window = 0;
+    // the dump is sent straight out of "last", so a window that ends
+    // while it is still going out is dropped
+    gieh = INTCONbits.GIEH;
+    INTCONbits.GIEH = 0;
+    if (!dumping) {
+        last = live;
+    }
+    busmon_clear(&live);
+    INTCONbits.GIEH = gieh;
+
+    if (!dumping) {
+        // (a transaction that spans the end of the window is counted in
+        // the window it ends in, so this can come out a little over 1000)
+        last.permille = last.busy / ((BUSMON_WINDOW * 65536UL) / 1000);
+        dumping = 1;
+        dump_pos = 0;
+        // get the transmit interrupt going if it isn't already
+        PIE1bits.TX1IE = 1;
+    }
+}
+
+void busmon_read(busmon_stats *sp) {
+    unsigned char gieh = INTCONbits.GIEH;
+
+    INTCONbits.GIEH = 0;
+    *sp = last;
+    INTCONbits.GIEH = gieh;
+}
+
+// the byte at pos in the dump
+
+static unsigned char busmon_byte(unsigned char pos) {
+    switch (pos) {
+        case 0: return (BUSMON_DUMP_MAGIC);
+        case 1: return (BUSMON_FORMAT);
+        case 2: return (BUSMON_WINDOW);
+        case 3: return (BUSMON_NUM_SLAVES);
+    }
+    // the PIC18 compilers lay a struct out little-endian with no padding
+    return (((unsigned char *) &last)[pos - BUSMON_HEADERLEN]);
+}
+
+signed char busmon_next(unsigned char *buf) {
+    signed char length = 0;
+
+    if (!dumping) {
+        return (0);
+    }
+    while ((length < MAXUARTBUF) && (dump_pos < BUSMON_HEADERLEN + sizeof (busmon_stats))) {
+        buf[length++] = busmon_byte(dump_pos++);
+    }
+    if (length == 0) {
+        dumping = 0;
+    }
+    return (length);
+}
+
+#endif
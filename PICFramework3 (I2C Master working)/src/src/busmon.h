@@ -0,0 +1,103 @@
+#ifndef __busmon_h
+#define __busmon_h
+
+#include "maindefs.h"
+
+// I2C master bus monitor (enabled with I2C_BUS_MONITOR in maindefs.h;
+// does nothing in the sensor PIC build and is refused in the motor PIC
+// one, whose UART carries the movement commands)
+//
+// Every transaction the master starts is timed with timer1, from the
+// start bit to the stop (or to the NACK that ends a read), and counted
+// against the slave it was addressed to.  The counts are kept over a
+// window of BUSMON_WINDOW timer1 overflows, about a second, at the end of
+// which they are copied out for busmon_read() and sent out of the UART,
+// and counting starts again from zero.  Busy time is the time inside
+// transactions; the rest of the window the bus was idle.
+//
+// A NACK of the address or of a byte written makes the master send the
+// address again (a retry, as often as it takes); a NACK of the address of
+// a read ends the transaction, which counts as failed.
+#ifdef __USE18F2680
+// timer1 counts Tcy at 8 MHz, so it overflows every 8.19 ms
+#define BUSMON_WINDOW 122
+#else
+// timer1 counts 8 Tcy at 12 MHz, so it overflows every 43.7 ms
+#define BUSMON_WINDOW 23
+#endif
+
+// the slaves kept apart -- any other address counts as BUSMON_OTHER
+#define BUSMON_SLAVES \
+    BUSMON_SLAVE(BUSMON_SENSOR, SENSORPIC_ADDR) \
+    BUSMON_SLAVE(BUSMON_MOTOR, MOTORPIC_ADDR)
+
+#define BUSMON_SLAVE(name, addr) name,
+enum {
+    BUSMON_SLAVES
+    BUSMON_OTHER,
+    BUSMON_NUM_SLAVES
+};
+#undef BUSMON_SLAVE
+
+// bucket n holds transactions of less than 2^n timer1 counts (and at
+// least 2^(n-1)), as in latency.h
+#define BUSMON_BUCKETS 17
+
+typedef struct __busmon_slave {
+    unsigned int transactions;
+    unsigned int nacks;
+    unsigned int retries;
+} busmon_slave;
+
+// All counts are for one window.  busy is in timer1 counts, and permille
+// is the part of the window it takes up (set at the end of the window).
+typedef struct __busmon_stats {
+    unsigned int transactions;
+    unsigned int failed;
+    unsigned int bytes;
+    unsigned long busy;
+    unsigned int permille;
+    unsigned int longest;
+    busmon_slave slaves[BUSMON_NUM_SLAVES];
+    unsigned int hist[BUSMON_BUCKETS];
+} busmon_stats;
+
+// At the end of each window the stats go out of the UART as a header and
+// then the busmon_stats above, little-endian, in the order they are
+// declared.  The dump goes ahead of anything main() sends with
+// uart_trans(), so the data forwarded from the slaves comes out either
+// before or after a whole dump, never inside one.  The header is
+//     BUSMON_DUMP_MAGIC, BUSMON_FORMAT, BUSMON_WINDOW, BUSMON_NUM_SLAVES
+// Transactions (or bytes) per second are the counts * 1000000 /
+// (BUSMON_WINDOW * 65536 * us per timer1 count).  A window that ends while
+// the last one is still going out is dropped, for the dump and for
+// busmon_read() both.
+#define BUSMON_DUMP_MAGIC 0xD5
+#define BUSMON_FORMAT 1
+
+#if defined(I2C_BUS_MONITOR) && defined(I2CMASTER)
+void init_busmon(void);
+// Called by i2c_master_send() just before the start bit
+void busmon_start(unsigned char);
+// Called from the I2C master interrupt handler when the slave NACKs and
+// the address is sent again, and when the transaction is over (with the
+// number of data bytes that went over the bus)
+void busmon_retry(void);
+void busmon_end(unsigned char, unsigned char);
+// Called from the timer1 interrupt handler
+void busmon_tick(void);
+// Copies out the stats for the last full window (from main())
+void busmon_read(busmon_stats *);
+// Called from the low priority (UART transmit) interrupt handler, as
+// capture_next()
+signed char busmon_next(unsigned char *);
+#else
+#define init_busmon()
+#define busmon_start(addr)
+#define busmon_retry()
+#define busmon_end(failed, bytes)
+#define busmon_tick()
+#define busmon_next(buf) (0)
+#endif
+
+#endif
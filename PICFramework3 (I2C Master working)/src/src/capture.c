@@ -0,0 +1,104 @@
+#include "maindefs.h"
+#ifndef __XC8
+#include <timers.h>
+#else
+#include <plib/timers.h>
+#endif
+#include "my_uart.h"
+#include "capture.h"
+
+#if defined(TRAFFIC_CAPTURE) && defined(MOTORPIC)
+#error "TRAFFIC_CAPTURE dumps would be mixed in with the movement commands to the motor controller"
+#endif
+
+#ifdef TRAFFIC_CAPTURE
+
+#define CAP_HEADERLEN 4
+
+// The I2C handler may interrupt the UART one, so a record is written with
+// GIEH clear.  Nothing is recorded while the dump is going out.
+static cap_record ring[CAP_RECORDS];
+static unsigned char ring_in;
+static unsigned char ring_count;
+static unsigned char overwritten;
+static unsigned char dumping;
+static unsigned int dump_pos;
+
+void init_capture() {
+    ring_in = 0;
+    ring_count = 0;
+    overwritten = 0;
+    dumping = 0;
+}
+
+void capture_record(unsigned char tag, unsigned char data) {
+    unsigned char gieh = INTCONbits.GIEH;
+    cap_record *rp;
+
+    INTCONbits.GIEH = 0;
+    if (!dumping) {
+        rp = &ring[ring_in];
+        rp->tag = tag;
+        rp->data = data;
+        rp->stamp = ReadTimer1();
+        ring_in = (ring_in + 1) % CAP_RECORDS;
+        if (ring_count < CAP_RECORDS) {
+            ring_count++;
+        } else if (overwritten < 0xFF) {
+            overwritten++;
+        }
+    }
+    INTCONbits.GIEH = gieh;
+}
+
+unsigned char capture_dump() {
+    if (!dumping) {
+        dumping = 1;
+        dump_pos = 0;
+        // get the transmit interrupt going if it isn't already
+        PIE1bits.TX1IE = 1;
+    }
+    return (ring_count);
+}
+
+// the byte at pos in the dump
+
+static unsigned char capture_byte(unsigned int pos) {
+    cap_record *rp;
+
+    switch (pos) {
+        case 0: return (CAP_DUMP_MAGIC);
+        case 1: return (CAP_FORMAT);
+        case 2: return (ring_count);
+        case 3: return (overwritten);
+    }
+    pos -= CAP_HEADERLEN;
+    rp = &ring[(ring_in + CAP_RECORDS - ring_count + pos / 4) % CAP_RECORDS];
+    switch (pos % 4) {
+        case 0: return (rp->tag);
+        case 1: return (rp->data);
+        case 2: return (rp->stamp & 0xFF);
+    }
+    return (rp->stamp >> 8);
+}
+
+signed char capture_next(unsigned char *buf) {
+    unsigned int end = CAP_HEADERLEN + 4 * (unsigned int) ring_count;
+    signed char length = 0;
+
+    if (!dumping) {
+        return (0);
+    }
+    while ((length < MAXUARTBUF) && (dump_pos < end)) {
+        buf[length++] = capture_byte(dump_pos++);
+    }
+    if (length == 0) {
+        // all out -- start capturing again
+        ring_count = 0;
+        overwritten = 0;
+        dumping = 0;
+    }
+    return (length);
+}
+
+#endif
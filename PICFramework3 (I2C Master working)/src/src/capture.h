@@ -0,0 +1,62 @@
+#ifndef __capture_h
+#define __capture_h
+
+// Traffic capture (enabled with TRAFFIC_CAPTURE in maindefs.h)
+//
+// Every I2C slave interrupt and every UART byte received is recorded, with
+// the timer1 count it was handled at, in a ring that keeps the most recent
+// CAP_RECORDS.  A 0xCE write stops the capture and sends the ring out of
+// the UART, oldest record first; capturing starts again, from empty, once
+// the last byte has gone.  The reply to the 0xCE is the number of records.
+//
+// The dump goes out of the UART after anything else that is waiting.  On
+// the motor PIC that UART carries the movement commands to the motor
+// controller, which would take the dump for commands, so it cannot be
+// built there.  The dump is a header followed by the records, four bytes
+// each (tools/capdecode.c prints them):
+//     CAP_DUMP_MAGIC, CAP_FORMAT, number of records, records overwritten
+//         (up to 255) since the capture started
+//     tag, data, timer1 count (little-endian)
+// For an I2C record the tag is SSPSTAT (D_A, P, S, R_W, UA, BF) as the
+// handler found it, with CAP_I2C_SSPOV for a receive overflow, and the
+// data is the byte read from SSPBUF (if BF was set).  For a UART record
+// the tag is CAP_UART with OERR and FERR from RCSTA, and the data is the
+// byte received.  Timer1 wraps after 65535 counts, so a longer gap between
+// two records cannot be told from a shorter one.
+
+#define CAP_RECORDS 64
+#define CAP_DUMP_MAGIC 0xCE
+#define CAP_FORMAT 1
+
+#define CAP_I2C_SSPSTAT 0x3F
+#define CAP_I2C_SSPOV 0x40
+#define CAP_UART 0x80
+#define CAP_UART_ERRS 0x06
+
+typedef struct __cap_record {
+    unsigned char tag;
+    unsigned char data;
+    unsigned int stamp;
+} cap_record;
+
+#ifdef TRAFFIC_CAPTURE
+void init_capture(void);
+// Called by the I2C slave and UART receive interrupt handlers
+void capture_record(unsigned char, unsigned char);
+#define capture_i2c(sspstat, sspov, data) \
+    capture_record(((sspstat) & CAP_I2C_SSPSTAT) | ((sspov) ? CAP_I2C_SSPOV : 0), (data))
+#define capture_uart(data) capture_record(CAP_UART | (RCSTA & CAP_UART_ERRS), (data))
+// Stops the capture and starts the dump, returning the number of records
+unsigned char capture_dump(void);
+// Called from the low priority (UART transmit) interrupt handler when it
+// has nothing else to send.  Copies the next part of the dump into the
+// buffer and returns its length, or 0 once the dump is over.
+signed char capture_next(unsigned char *);
+#else
+#define init_capture()
+#define capture_i2c(sspstat, sspov, data)
+#define capture_uart(data)
+#define capture_next(buf) (0)
+#endif
+
+#endif
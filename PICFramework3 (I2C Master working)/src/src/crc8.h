@@ -0,0 +1,25 @@
+#ifndef __crc8_h
+#define __crc8_h
+
+// CRC-8 with polynomial x^8 + x^2 + x + 1 (0x07), an initial value of 0 and
+// no final XOR.  It is meant to be updated one byte at a time as bytes come
+// in or go out, so there is never a separate pass over the buffer -- each
+// update is a single lookup in a 256-entry table kept in program memory.
+//
+// That should come to roughly 12-15 instruction cycles a byte in the
+// interrupt handlers (an XOR, the TBLPTR setup and TBLRD* for the lookup,
+// and a store), which is an estimate from the instructions the update needs
+// and has not been measured on the part.  A byte lasts about 1040 cycles
+// at 115200 baud and 12500 at 9600 (Fcy = 12 MHz).
+
+#define CRC8_INIT 0x00
+
+#ifdef __XC8
+extern const unsigned char crc8_table[256];
+#else
+extern rom const unsigned char crc8_table[256];
+#endif
+
+#define crc8_update(crc, byte) (crc8_table[(unsigned char) ((crc) ^ (byte))])
+
+#endif
@@ -0,0 +1,41 @@
+#include "maindefs.h"
+#include "int_sources.h"
+#include "my_i2c.h"
+#include "defer.h"
+
+#ifdef I2C_DEFERRED
+
+volatile unsigned char defer_pending[NUM_WORK];
+
+void init_defer() {
+    unsigned char i;
+
+    for (i = 0; i < NUM_WORK; i++) {
+        defer_pending[i] = 0;
+    }
+}
+
+void defer_run() {
+    // each item is cleared before it runs, so that if the top half posts it
+    // again meanwhile the flag is set again and it runs once more
+#define WORK(name, handler) \
+    if (defer_pending[name]) { \
+        defer_pending[name] = 0; \
+        handler(); \
+    }
+    DEFERRED_WORK
+#undef WORK
+}
+
+unsigned char defer_waiting() {
+    unsigned char i;
+
+    for (i = 0; i < NUM_WORK; i++) {
+        if (defer_pending[i]) {
+            return (1);
+        }
+    }
+    return (0);
+}
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef __defer_h
+#define __defer_h
+
+// Deferred work (enabled with I2C_DEFERRED in maindefs.h)
+//
+// A high priority handler (the "top half") does only what cannot wait and
+// posts the rest as a work item.  Posting sets the flag of an interrupt
+// source that is otherwise unused (see int_sources.h), so the work runs as
+// soon as no high priority handler is running, at low priority, where it
+// no longer delays the next high priority interrupt.
+//
+// Each item has its own pending byte: the top half only ever sets it and
+// defer_run() only ever clears it, so neither has to mask the other.
+//
+//      item                handler
+#define DEFERRED_WORK \
+    WORK(WORK_I2C_SLAVE,    i2c_slave_work)
+
+#define WORK(name, handler) name,
+enum {
+    DEFERRED_WORK
+    NUM_WORK
+};
+#undef WORK
+
+#ifdef I2C_DEFERRED
+extern volatile unsigned char defer_pending[NUM_WORK];
+
+#define defer_post(work) { \
+    defer_pending[work] = 1; \
+    DEFER_IF = 1; \
+}
+
+void init_defer(void);
+// the low priority interrupt handler for the deferred work
+void defer_run(void);
+// is any work waiting?
+unsigned char defer_waiting(void);
+#else
+#define init_defer()
+#endif
+
+#endif
@@ -0,0 +1,115 @@
+#include "maindefs.h"
+#include "messages.h"
+#include "my_i2c.h"
+#include "dready.h"
+#include "frame_delta.h"
+#include "crc8.h"
+
+#if defined(DATA_READY) && defined(I2CMASTER) && !defined(__USE18F26J50) && !defined(__USE18F46J50)
+#error "DATA_READY maps INT3 with the J50 peripheral pin select"
+#endif
+
+#ifdef DATA_READY
+
+#ifdef I2CMASTER
+// a read from the sensor PIC is under way (main() only)
+static unsigned char busy;
+#ifdef FRAME_DELTA
+// the last frame decoded, and the sequence number it is acked with
+static unsigned char frame[MAXUARTBUF];
+static unsigned char acked;
+#endif
+
+void init_dready() {
+    busy = 0;
+#ifdef FRAME_DELTA
+    acked = FD_NOSEQ;
+#endif
+    DREADY_PCFG = 1;
+    DREADY_TRIS = 1;
+    RPINR3 = DREADY_RP;
+    INTCON2bits.INTEDG3 = 1;
+}
+
+void dready_int_handler() {
+    ToMainLow_sendmsg(0, MSGT_DATA_READY, (void *) 0);
+}
+
+void dready_fetch() {
+#ifdef FRAME_DELTA
+    // the block-form ack, [0xAB, 1, seq]
+    unsigned char cmd[3];
+
+    cmd[0] = DREADY_CMD;
+    cmd[1] = 1;
+    cmd[2] = acked;
+    if (!busy) {
+        busy = 1;
+        i2c_master_send(3, DREADY_READLEN, cmd, DREADY_ADDR);
+    }
+#else
+    unsigned char cmd = DREADY_CMD;
+
+    if (!busy) {
+        busy = 1;
+        i2c_master_send(1, DREADY_READLEN, &cmd, DREADY_ADDR);
+    }
+#endif
+}
+
+#ifdef FRAME_DELTA
+unsigned char dready_decode(unsigned char *reply, unsigned char length) {
+    unsigned char i;
+#ifdef FRAME_CRC
+    unsigned char crc = CRC8_INIT;
+
+    // the CRC covers the coded reply, not the frame
+    if (length < 2) {
+        acked = FD_NOSEQ;
+        return (0);
+    }
+    length--;
+    for (i = 0; i < length; i++) {
+        crc = crc8_update(crc, reply[i]);
+    }
+    if (crc != reply[length]) {
+        acked = FD_NOSEQ;
+        return (0);
+    }
+#endif
+    acked = frame_delta_decode(reply, length, frame);
+    if (acked == FD_NOSEQ) {
+        return (0);
+    }
+    for (i = 0; i < MAXUARTBUF; i++) {
+        reply[i] = frame[i];
+    }
+    return (MAXUARTBUF);
+}
+#endif
+
+// The line is looked at again on every timer1 overflow, in case the
+// message for an edge was lost because ToMainLow was full (a fetch that is
+// already under way just ignores the extra one)
+
+void dready_tick() {
+    if (DREADY_PORT) {
+        ToMainLow_sendmsg(0, MSGT_DATA_READY, (void *) 0);
+    }
+}
+
+void dready_done() {
+    busy = 0;
+    // no new edge if there was more behind what was just read
+    if (DREADY_PORT) {
+        dready_fetch();
+    }
+}
+#else
+void init_dready() {
+    DREADY_LAT = 0;
+    DREADY_TRIS = 0;
+}
+#endif
+
+#endif
@@ -0,0 +1,80 @@
+#ifndef __dready_h
+#define __dready_h
+
+// Data-ready line (enabled with DATA_READY in maindefs.h)
+//
+// A slave raises the line only when a sensor frame has been queued for
+// 0xAB/0xBB (with I2C_REGMAP, once the frame is in the map as well), which
+// is what the master reads when it sees the line, and drops it once the
+// master has read the last one.  Reads of the fused sensors or of the
+// register map leave it alone.  The master takes the line on INT3 (mapped
+// with the J50 peripheral pin select), and only then reads from the sensor
+// PIC, so it never has to poll for data.  The line can be raised again
+// just after a read that emptied the queue, which costs the master one
+// read of nothing.
+//
+// RB3 on both ends: an output on the slaves and an input on the master.
+// INT3 only fires on the rising edge, so after each read the master looks
+// at the line again to see whether there is more, and it also looks on
+// every timer1 overflow (about every 44 ms) in case an edge was missed.
+#define DREADY_LAT LATBbits.LATB3
+#define DREADY_TRIS TRISBbits.TRISB3
+#define DREADY_PORT PORTBbits.RB3
+// RB3 is RP6, and AN9 on the J50 parts
+#define DREADY_RP 6
+#define DREADY_PCFG ANCON1bits.PCFG9
+
+// What the master reads when the line goes up: a frame (and its CRC with
+// FRAME_CRC), or with SMBUS_BLOCK a count and then the reply, which can be
+// anything up to a frame, its CRC, and a FRAME_DELTA header
+#define DREADY_CMD 0xAB
+#ifdef SMBUS_BLOCK
+#define DREADY_READLEN MSGLEN
+#elif defined(FRAME_CRC)
+#define DREADY_READLEN 6
+#else
+#define DREADY_READLEN 5
+#endif
+#define DREADY_ADDR SENSORPIC_ADDR
+
+#ifdef DATA_READY
+// Called once the ports are set up (after main() sets TRISB), before
+// interrupts are enabled
+void init_dready(void);
+#ifdef I2CMASTER
+// the low priority interrupt handlers for INT3 and the timer1 overflow
+void dready_int_handler(void);
+void dready_tick(void);
+// Called from main() when the line has gone up, and when a read from the
+// sensor PIC has finished
+void dready_fetch(void);
+void dready_done(void);
+#define dready_set() ((void)0)
+#define dready_clear() ((void)0)
+#else
+#define dready_set() (DREADY_LAT = 1)
+#define dready_clear() (DREADY_LAT = 0)
+#define dready_tick()
+#define dready_fetch()
+#define dready_done()
+#endif
+#else
+#define init_dready()
+#define dready_set() ((void)0)
+#define dready_clear() ((void)0)
+#define dready_tick()
+#define dready_fetch()
+#define dready_done()
+#endif
+
+#if defined(DATA_READY) && defined(I2CMASTER) && defined(FRAME_DELTA)
+// Decodes a reply (after the count) into the last frame, which is copied
+// back over the reply, and returns its length -- or 0 if the reply was bad,
+// so the next fetch asks for a keyframe
+unsigned char dready_decode(unsigned char *, unsigned char);
+#else
+// (only the master's fetches ack a frame, so nothing else is coded)
+#define dready_decode(reply, length) (length)
+#endif
+
+#endif
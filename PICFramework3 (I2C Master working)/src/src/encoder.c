@@ -0,0 +1,108 @@
+#include "maindefs.h"
+#include "encoder.h"
+
+#if defined(QUAD_ENCODERS) && !defined(__USE18F26J50) && !defined(__USE18F46J50)
+#error "QUAD_ENCODERS maps its interrupts with the J50 peripheral pin select"
+#endif
+#if defined(QUAD_ENCODERS) && defined(CLOCK_GOVERNOR)
+#error "CLOCK_GOVERNOR changes the timer1 rate the encoder speeds are per"
+#endif
+
+#ifdef QUAD_ENCODERS
+
+// enc_count is only written by the encoder handlers and speeds only by
+// enc_tick(); everything else reads them with GIEH clear.
+static volatile signed long enc_count[NUM_ENCODERS];
+static signed long last_count[NUM_ENCODERS];
+static signed int speeds[NUM_ENCODERS];
+
+void init_encoders() {
+    unsigned char i;
+
+    for (i = 0; i < NUM_ENCODERS; i++) {
+        enc_count[i] = 0;
+        last_count[i] = 0;
+        speeds[i] = 0;
+    }
+    // Start on rising edges -- if A is already high the first (falling)
+    // edge is missed, and the edges are in step from the next one on
+#define ENCODER(name, n, rp, a_tris, b_port, b_tris) \
+    a_tris = 1; \
+    b_tris = 1; \
+    RPINR##n = (rp); \
+    INTCON2bits.INTEDG##n = 1;
+    ENCODERS
+#undef ENCODER
+}
+
+// The edge that was just seen says what A is now: A leading B (A and B
+// differ after the edge) is forwards.  The handlers are called from the
+// table in int_sources.h, which must list the same INTx.
+#define ENCODER(name, n, rp, a_tris, b_port, b_tris) \
+void enc_int##n##_handler() { \
+    if (INTCON2bits.INTEDG##n == (b_port)) { \
+        enc_count[name]--; \
+    } else { \
+        enc_count[name]++; \
+    } \
+    INTCON2bits.INTEDG##n = !INTCON2bits.INTEDG##n; \
+}
+ENCODERS
+#undef ENCODER
+
+signed long enc_position(unsigned char enc) {
+    unsigned char gieh = INTCONbits.GIEH;
+    signed long pos;
+
+    INTCONbits.GIEH = 0;
+    pos = enc_count[enc];
+    INTCONbits.GIEH = gieh;
+    return (pos);
+}
+
+signed int enc_speed(unsigned char enc) {
+    unsigned char gieh = INTCONbits.GIEH;
+    signed int speed;
+
+    INTCONbits.GIEH = 0;
+    speed = speeds[enc];
+    INTCONbits.GIEH = gieh;
+    return (speed);
+}
+
+void enc_tick() {
+    unsigned char gieh;
+    unsigned char i;
+    signed long pos;
+    signed int speed;
+
+    for (i = 0; i < NUM_ENCODERS; i++) {
+        pos = enc_position(i);
+        speed = (signed int) (pos - last_count[i]);
+        last_count[i] = pos;
+        gieh = INTCONbits.GIEH;
+        INTCONbits.GIEH = 0;
+        speeds[i] = speed;
+        INTCONbits.GIEH = gieh;
+    }
+}
+
+unsigned char enc_report(unsigned char *buf) {
+    unsigned char i;
+    signed long pos;
+    signed int speed;
+
+    for (i = 0; i < NUM_ENCODERS; i++) {
+        pos = enc_position(i);
+        buf[4 * i] = pos & 0xFF;
+        buf[4 * i + 1] = (pos >> 8) & 0xFF;
+        buf[4 * i + 2] = (pos >> 16) & 0xFF;
+        buf[4 * i + 3] = (pos >> 24) & 0xFF;
+        speed = enc_speed(i);
+        buf[4 * NUM_ENCODERS + 2 * i] = speed & 0xFF;
+        buf[4 * NUM_ENCODERS + 2 * i + 1] = (speed >> 8) & 0xFF;
+    }
+    return (ENC_REPORTLEN);
+}
+
+#endif
@@ -0,0 +1,57 @@
+#ifndef __encoder_h
+#define __encoder_h
+
+// Quadrature wheel encoders (enabled with QUAD_ENCODERS in maindefs.h, J50
+// parts)
+//
+// The A channel of each encoder drives one of the external interrupts,
+// mapped to it with the peripheral pin select, and the B channel is read
+// as a plain input.  The interrupt edge is flipped every time, so both
+// edges of A are counted (half the full quadrature resolution), up or
+// down depending on B.  The PORTB interrupt-on-change can't be used for
+// this on the J50 parts because RB4 and RB5 are the I2C pins.
+//
+// Each handler is only a compare, a 32-bit increment or decrement and an
+// edge flip.  If A changes again before the handler flips the edge, that
+// edge is missed, so the highest edge rate is roughly one per handler
+// time plus the longest time high priority interrupts are held off.
+//
+// The positions are read with GIEH clear so they are never torn, and the
+// speed of each encoder is the change in its position over the last
+// timer1 overflow (65536 timer1 counts).
+//
+//      encoder     INTx    A pin (RPn) A TRIS bit          B port bit      B TRIS bit
+#define ENCODERS \
+    ENCODER(ENC_LEFT,  1,   11,         TRISCbits.TRISC0,   PORTCbits.RC1,  TRISCbits.TRISC1) \
+    ENCODER(ENC_RIGHT, 2,   9,          TRISBbits.TRISB6,   PORTBbits.RB7,  TRISBbits.TRISB7)
+
+#define ENCODER(name, n, rp, a_tris, b_port, b_tris) name,
+enum {
+    ENCODERS
+    NUM_ENCODERS
+};
+#undef ENCODER
+
+// The encoder part of the 0xBB reply: the position of each encoder (a
+// signed little-endian long) and then the speed of each (a signed
+// little-endian word)
+#define ENC_REPORTLEN (NUM_ENCODERS * 6)
+
+#ifdef QUAD_ENCODERS
+// Called once the ports are set up (after main() sets TRISB), before
+// interrupts are enabled
+void init_encoders(void);
+// the high priority interrupt handlers
+void enc_int1_handler(void);
+void enc_int2_handler(void);
+// Works out the speeds, from the timer1 interrupt handler
+void enc_tick(void);
+signed long enc_position(unsigned char);
+signed int enc_speed(unsigned char);
+unsigned char enc_report(unsigned char *);
+#else
+#define init_encoders()
+#define enc_tick()
+#endif
+
+#endif
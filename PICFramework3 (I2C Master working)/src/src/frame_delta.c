@@ -0,0 +1,108 @@
+#include "maindefs.h"
+#include "frame_delta.h"
+
+#if defined(FRAME_DELTA) && !defined(SMBUS_BLOCK)
+#error "FRAME_DELTA replies vary in length and need SMBUS_BLOCK"
+#endif
+
+#ifdef FRAME_DELTA
+
+// the last frame sent, which is what the master has if it acks fd_sent_seq
+static unsigned char fd_ref[MAXUARTBUF];
+static unsigned char fd_sent_seq;
+static unsigned char fd_seq;
+
+void init_frame_delta() {
+    fd_sent_seq = FD_NOSEQ;
+    fd_seq = 0;
+}
+
+unsigned char frame_delta_encode(unsigned char *frame, unsigned char acked, unsigned char *out) {
+    unsigned char i;
+    unsigned char len = MAXUARTBUF + 1;
+    unsigned char run = 0;
+    signed char d;
+
+    fd_seq = (fd_seq + 1) & FD_SEQ_MASK;
+    if ((acked != FD_NOSEQ) && (acked == fd_sent_seq)) {
+        out[0] = fd_seq;
+        len = 1;
+        for (i = 0; i < MAXUARTBUF; i++) {
+            d = (signed char) (frame[i] - fd_ref[i]);
+            if (d == 0) {
+                run++;
+                continue;
+            }
+            if (run) {
+                out[len++] = FD_RUN | (run - 1);
+                run = 0;
+            }
+            if ((d >= -32) && (d <= 31)) {
+                out[len++] = FD_SMALL | (d & 0x3F);
+            } else {
+                out[len++] = FD_LITERAL;
+                out[len++] = frame[i];
+            }
+        }
+        if (run) {
+            out[len++] = FD_RUN | (run - 1);
+        }
+    }
+    if (len > MAXUARTBUF) {
+        // no ack, or no saving -- send the whole frame
+        out[0] = FD_KEY | fd_seq;
+        for (i = 0; i < MAXUARTBUF; i++) {
+            out[i + 1] = frame[i];
+        }
+        len = MAXUARTBUF + 1;
+    }
+    for (i = 0; i < MAXUARTBUF; i++) {
+        fd_ref[i] = frame[i];
+    }
+    fd_sent_seq = fd_seq;
+    return (len);
+}
+
+unsigned char frame_delta_decode(unsigned char *in, unsigned char len, unsigned char *frame) {
+    unsigned char i = 0;
+    unsigned char j;
+    unsigned char code;
+
+    if (len == 0) {
+        return (FD_NOSEQ);
+    }
+    if (in[0] & FD_KEY) {
+        if (len != MAXUARTBUF + 1) {
+            return (FD_NOSEQ);
+        }
+        for (i = 0; i < MAXUARTBUF; i++) {
+            frame[i] = in[i + 1];
+        }
+        return (in[0] & FD_SEQ_MASK);
+    }
+    for (j = 1; j < len; j++) {
+        code = in[j];
+        if (i >= MAXUARTBUF) {
+            return (FD_NOSEQ);
+        }
+        if (code == FD_LITERAL) {
+            if (++j >= len) {
+                return (FD_NOSEQ);
+            }
+            frame[i++] = in[j];
+        } else if (code & FD_LITERAL) {
+            return (FD_NOSEQ);
+        } else if (code & FD_SMALL) {
+            // sign-extend the 6-bit delta
+            frame[i++] += (code & 0x20) ? (code | 0xC0) : (code & 0x3F);
+        } else {
+            i += (code & 0x3F) + 1;
+        }
+    }
+    if (i != MAXUARTBUF) {
+        return (FD_NOSEQ);
+    }
+    return (in[0]);
+}
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef __frame_delta_h
+#define __frame_delta_h
+
+#include "my_uart.h"
+
+// Compact 0xAB replies (enabled with FRAME_DELTA in maindefs.h)
+//
+// The master acknowledges the last frame it decoded by writing its
+// sequence number after the command as a block write, [0xAB, 1, seq], and
+// the slave then sends the next frame as a delta against that one.  Without
+// a matching ack (a bare [0xAB], the first poll, a lost reply, a frame that
+// failed to decode) it sends a keyframe instead, as it also does when the
+// delta would not be shorter.  On the master this is done by dready.c, and
+// tools/deltatest.c runs the two ends against each other on the host.
+//
+// A reply starts with a header byte: FD_KEY plus the sequence number for a
+// keyframe, followed by the MAXUARTBUF bytes of the frame, or just the
+// sequence number for a delta, followed by codes that walk the frame from
+// the first byte to the last:
+//   FD_RUN   | (n - 1)   the next n bytes are unchanged (n <= 64)
+//   FD_SMALL | d         the next byte changed by d (6-bit, -32..31)
+//   FD_LITERAL, byte     the next byte is this
+// An unchanged frame is two bytes and a keyframe is MAXUARTBUF + 1.
+// The reply length varies, so this sits on top of SMBUS_BLOCK.
+
+#define FD_KEY 0x80
+#define FD_SEQ_MASK 0x7F
+#define FD_NOSEQ 0x80     // not a valid sequence number
+#define FD_RUN 0x00
+#define FD_SMALL 0x40
+#define FD_LITERAL 0x80
+// room for the longest delta, before it is swapped for a keyframe
+#define FD_BUFLEN (2 * MAXUARTBUF + 1)
+
+#ifdef FRAME_DELTA
+void init_frame_delta(void);
+// Called by the I2C handler with a new frame and the sequence number the
+// master acknowledged (or FD_NOSEQ).  Fills in the reply, returns its length.
+unsigned char frame_delta_encode(unsigned char *, unsigned char, unsigned char *);
+// The master's side: applies a reply to the last frame it decoded, in
+// place, and returns the sequence number to acknowledge, or FD_NOSEQ if the
+// reply was malformed (the frame is then garbage until the next keyframe).
+unsigned char frame_delta_decode(unsigned char *, unsigned char, unsigned char *);
+#else
+#define init_frame_delta()
+#endif
+
+#endif
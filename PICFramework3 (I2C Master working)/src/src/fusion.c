@@ -0,0 +1,132 @@
+#include "maindefs.h"
+#ifndef __XC8
+#include <adc.h>
+#else
+#include <plib/adc.h>
+#endif
+#include "user_interrupts.h"
+#include "fusion.h"
+
+#ifdef SENSOR_FUSION
+
+#define SENSOR(name, source, bearing, inverted) source,
+static const unsigned char sources[NUM_FUSION_SENSORS] = {
+    FUSION_SENSORS
+};
+#undef SENSOR
+#define SENSOR(name, source, bearing, inverted) bearing,
+static const unsigned char bearings[NUM_FUSION_SENSORS] = {
+    FUSION_SENSORS
+};
+#undef SENSOR
+#define SENSOR(name, source, bearing, inverted) inverted,
+static const unsigned char inverteds[NUM_FUSION_SENSORS] = {
+    FUSION_SENSORS
+};
+#undef SENSOR
+
+// fusion_update() runs in the UART receive handler and the I2C handler
+// may interrupt it, so the result is built up here and copied into
+// "fused" (in report order) with GIEH clear.
+static unsigned char fused[FUSION_REPORTLEN];
+static unsigned char last_nearest;
+static unsigned char primed;
+static unsigned char seq_nearest;
+// rate of change, in 1/16 distance units per frame
+static signed int rate16;
+
+void init_fusion() {
+    unsigned char i;
+
+    for (i = 0; i < FUSION_REPORTLEN; i++) {
+        fused[i] = 0;
+    }
+    primed = 0;
+    seq_nearest = 0xFF;
+    rate16 = 0;
+}
+
+void fusion_update(unsigned char *frame) {
+    unsigned char i;
+    unsigned char raw;
+    unsigned char nearest = 0xFF;
+    unsigned char bearing = 0;
+    unsigned char flags = 0;
+    signed char rate;
+    unsigned char gieh;
+
+    for (i = 0; i < NUM_FUSION_SENSORS; i++) {
+        if (sources[i] == FUSE_SRC_ADC) {
+            // adcbuffer[0] counts the readings in it, and the last one
+            // in is the latest
+            if (adcbuffer[0] == 0) {
+                continue;
+            }
+            raw = adcbuffer[adcbuffer[0]];
+        } else {
+            raw = frame[sources[i]];
+        }
+        if (inverteds[i]) {
+            raw = 0xFF - raw;
+        }
+        if (raw < nearest) {
+            nearest = raw;
+            bearing = bearings[i];
+        }
+    }
+    // start the next ADC reading, to be ready for the next frame
+    if (!BusyADC()) {
+        ConvertADC();
+    }
+
+    // a slow moving average of the change per frame (from the second one)
+    if (primed) {
+        rate16 += (((signed int) nearest - last_nearest) * 16 - rate16) / 4;
+    }
+    last_nearest = nearest;
+    primed = 1;
+    if (rate16 > 127 * 16) {
+        rate = 127;
+    } else if (rate16 < -127 * 16) {
+        rate = -127;
+    } else {
+        rate = rate16 / 16;
+    }
+
+    if (nearest < FUSE_NEAR_DIST) {
+        flags |= FUSE_NEAR;
+    }
+    if (nearest < FUSE_STOP_DIST) {
+        flags |= FUSE_STOP;
+    }
+    if (rate <= -FUSE_CLOSING_RATE) {
+        flags |= FUSE_CLOSING;
+    }
+
+    gieh = INTCONbits.GIEH;
+    INTCONbits.GIEH = 0;
+    if ((bearing != fused[2]) || (flags != fused[3])
+            || (nearest > seq_nearest + FUSE_HYSTERESIS)
+            || (nearest + FUSE_HYSTERESIS < seq_nearest)) {
+        fused[0]++;
+        seq_nearest = nearest;
+    }
+    fused[1] = nearest;
+    fused[2] = bearing;
+    fused[3] = flags;
+    fused[4] = (unsigned char) rate;
+    INTCONbits.GIEH = gieh;
+}
+
+// Called from the I2C handler, which the update cannot interrupt
+
+unsigned char fusion_report(unsigned char *buf) {
+    unsigned char i;
+
+    for (i = 0; i < FUSION_REPORTLEN; i++) {
+        buf[i] = fused[i];
+    }
+    return (FUSION_REPORTLEN);
+}
+
+#endif
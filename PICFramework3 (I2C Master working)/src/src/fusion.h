@@ -0,0 +1,63 @@
+#ifndef __fusion_h
+#define __fusion_h
+
+// Sensor fusion (enabled with SENSOR_FUSION in maindefs.h)
+//
+// Each complete UART frame, together with the latest ADC reading, is
+// reduced to the nearest obstacle: how far, in which direction, whether it
+// is inside the thresholds below, and how fast it is getting closer.  The
+// master can read these few bytes with 0xAC instead of whole 0xAB frames.
+//
+// The table says where each range reading comes from (a byte of the UART
+// frame, or the ADC), which way the sensor points, as a binary angle (256
+// to a turn, counterclockwise from straight ahead), and whether its
+// reading goes down as things get further away (like the IR sensors on the
+// ADC), in which case it is flipped before use.  Change it to match the
+// sensors wired to this node.
+//
+//      sensor          source          bearing inverted
+#define FUSION_SENSORS \
+    SENSOR(FS_IR_FRONT, FUSE_SRC_ADC,   0x00,   1) \
+    SENSOR(FS_LEFT,     0,              0x40,   0) \
+    SENSOR(FS_FRONT,    1,              0x00,   0) \
+    SENSOR(FS_RIGHT,    2,              0xC0,   0)
+
+#define FUSE_SRC_ADC 0xFF
+
+#define SENSOR(name, source, bearing, inverted) name,
+enum {
+    FUSION_SENSORS
+    NUM_FUSION_SENSORS
+};
+#undef SENSOR
+
+// thresholds on the nearest distance, and on how fast it is shrinking (in
+// distance units per frame)
+#define FUSE_NEAR_DIST 60
+#define FUSE_STOP_DIST 20
+#define FUSE_CLOSING_RATE 4
+// the sequence number only moves when the nearest distance has changed by
+// more than this since the last time, or the bearing or flags change
+#define FUSE_HYSTERESIS 2
+
+#define FUSE_NEAR 0x01
+#define FUSE_STOP 0x02
+#define FUSE_CLOSING 0x04
+
+// The reply to a 0xAC write is the sequence number, the nearest distance,
+// its bearing, the flags and the rate of change (signed, negative when
+// closing).  If the byte after the command is the sequence number the
+// master already has, the reply is just the sequence number.
+#define FUSION_REPORTLEN 5
+
+#ifdef SENSOR_FUSION
+void init_fusion(void);
+// Called from the low priority (UART receive) interrupt handler
+void fusion_update(unsigned char *);
+unsigned char fusion_report(unsigned char *);
+#else
+#define init_fusion()
+#define fusion_update(frame)
+#endif
+
+#endif
@@ -0,0 +1,141 @@
+#include "maindefs.h"
+#ifndef __XC8
+#include <timers.h>
+#else
+#include <plib/timers.h>
+#endif
+#include "my_i2c.h"
+#include "governor.h"
+
+#ifdef CLOCK_GOVERNOR
+
+#if !defined(__USE18F26J50) && !defined(__USE18F46J50)
+#error "CLOCK_GOVERNOR is written for the HSPLL clock of the J50 parts"
+#endif
+#ifndef TICKLESS_IDLE
+#error "CLOCK_GOVERNOR goes slow from the idle path of TICKLESS_IDLE"
+#endif
+
+// timer0 prescaler (T0PS) 1:64 and 1:8, timer1 prescaler (T1CKPS) 1:8 and 1:1
+#define GOV_T0PS_FAST 0x5
+#define GOV_T0PS_SLOW 0x2
+#define GOV_T1CKPS_FAST 0x3
+#define GOV_T1CKPS_SLOW 0x0
+
+volatile unsigned char gov_active;
+static unsigned char level;
+static unsigned int ticks[GOV_NUM_LEVELS];
+static unsigned int switches;
+static unsigned int wake_max;
+static unsigned int wake_last;
+
+void init_governor() {
+    gov_active = 0;
+    level = GOV_FAST;
+    gov_clear();
+}
+
+// set the peripherals up for the clock now running (with GIEH clear)
+
+static void gov_retune() {
+    if (level == GOV_FAST) {
+        BAUDCON1bits.BRG16 = 0;
+        TXSTA1bits.BRGH = 0;
+        SPBRG1 = GOV_SPBRG_FAST;
+        T0CONbits.T0PS = GOV_T0PS_FAST;
+        T1CONbits.T1CKPS = GOV_T1CKPS_FAST;
+#ifdef I2CMASTER
+        SSPADD = I2C_MASTER_SSPADD;
+#endif
+    } else {
+        BAUDCON1bits.BRG16 = 1;
+        TXSTA1bits.BRGH = 1;
+        SPBRG1 = GOV_SPBRG_SLOW;
+        T0CONbits.T0PS = GOV_T0PS_SLOW;
+        T1CONbits.T1CKPS = GOV_T1CKPS_SLOW;
+#ifdef I2CMASTER
+        SSPADD = GOV_SSPADD_SLOW;
+#endif
+    }
+}
+
+void gov_idle() {
+    if (gov_active) {
+        // busy since the last time -- stay fast for now
+        gov_active = 0;
+        return;
+    }
+    if (level == GOV_SLOW) {
+        return;
+    }
+    // don't change the baud rate under a byte on the wire
+    if (!BAUDCON1bits.RCIDL || !TXSTA1bits.TRMT || PIE1bits.TX1IE) {
+        return;
+    }
+    // the 8 MHz internal oscillator is ready at once, and the primary clock
+    // is shut down as soon as it is switched away from
+    OSCCONbits.IRCF = 0x7;
+    OSCCONbits.SCS = 0x3;
+    level = GOV_SLOW;
+    gov_retune();
+}
+
+void gov_run() {
+    unsigned int start;
+    unsigned int elapsed;
+
+    if (!gov_active || (level == GOV_FAST)) {
+        return;
+    }
+    start = ReadTimer1();
+    OSCCONbits.SCS = 0x0;
+    // still running from the internal oscillator until the crystal and PLL
+    // are up, and the handlers carry on meanwhile
+    while (!OSCCONbits.OSTS);
+    INTCONbits.GIEH = 0;
+    // (slow timer1 counts are 0.5 us, and the last few are fast ones)
+    elapsed = (ReadTimer1() - start) / 2;
+    // as in gov_idle(), don't change the baud rate under a byte on the
+    // wire; with GIEH clear the transmit handler can't start another one,
+    // and the receive buffer holds two more while this waits
+    while (!BAUDCON1bits.RCIDL || !TXSTA1bits.TRMT);
+    level = GOV_FAST;
+    gov_retune();
+    INTCONbits.GIEH = 1;
+
+    switches++;
+    wake_last = elapsed;
+    if (elapsed > wake_max) {
+        wake_max = elapsed;
+    }
+}
+
+void gov_ticks(unsigned char n) {
+    ticks[level] += n;
+}
+
+unsigned char gov_report(unsigned char *buf) {
+    unsigned int words[GOV_REPORTLEN / 2];
+    unsigned char i;
+
+    words[0] = ticks[GOV_FAST];
+    words[1] = ticks[GOV_SLOW];
+    words[2] = switches;
+    words[3] = wake_max;
+    words[4] = wake_last;
+    for (i = 0; i < GOV_REPORTLEN / 2; i++) {
+        buf[2 * i] = words[i] & 0xFF;
+        buf[2 * i + 1] = words[i] >> 8;
+    }
+    return (GOV_REPORTLEN);
+}
+
+void gov_clear() {
+    ticks[GOV_FAST] = 0;
+    ticks[GOV_SLOW] = 0;
+    switches = 0;
+    wake_max = 0;
+    wake_last = 0;
+}
+
+#endif
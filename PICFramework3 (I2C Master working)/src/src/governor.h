@@ -0,0 +1,70 @@
+#ifndef __governor_h
+#define __governor_h
+
+#include "my_i2c.h"
+
+// Clock governor (enabled with CLOCK_GOVERNOR in maindefs.h, J50 parts)
+//
+// The processor runs from the 48 MHz primary clock (HSPLL) while there is
+// work to do, and drops to the 8 MHz internal oscillator (RC_RUN, with the
+// crystal and PLL shut down) when main() goes idle with no I2C or UART
+// activity since it last went idle.  It goes back to the PLL as soon as
+// main() wakes up to find that the I2C or UART handlers have run; they keep
+// working while slow, the I2C slave by stretching the clock.
+//
+// At each switch the UART baud generator, timer0 and timer1 prescalers and
+// (in master mode) the I2C baud rate are set for the new clock.  The UART
+// and I2C rates come out the same; the timer prescalers have to be powers
+// of two, so slow timer0 ticks are 1.0 ms instead of 1.4 ms and slow timer1
+// counts are 0.5 us instead of 0.67 us.
+//
+// Going back up takes the crystal start-up and PLL lock time (up to about
+// 2 ms), which is what gov_wake_us measures.  Neither switch is made
+// while a UART byte is on the wire either way (going down waits for the
+// next idle, going up waits for the byte), so only a byte that starts in
+// the few cycles before the new rate is set can be lost (FRAME_CRC catches
+// it).
+
+#define GOV_FAST 0
+#define GOV_SLOW 1
+#define GOV_NUM_LEVELS 2
+
+#define GOV_FOSC_FAST 48000000UL
+#define GOV_FOSC_SLOW 8000000UL
+// main() sets up the UART with BRGH = 0 (Fosc / 64 / (n + 1)), the slow
+// clock uses BRGH = 1 and BRG16 = 1 (Fosc / 4 / (n + 1)) for the same rate
+#define GOV_SPBRG_FAST 0x19
+#define GOV_UART_BAUD (GOV_FOSC_FAST / 64 / (GOV_SPBRG_FAST + 1))
+#define GOV_SPBRG_SLOW ((GOV_FOSC_SLOW + 2 * GOV_UART_BAUD) / (4 * GOV_UART_BAUD) - 1)
+#define GOV_SSPADD_SLOW ((I2C_MASTER_SSPADD + 1) * (GOV_FOSC_SLOW / 1000) / (GOV_FOSC_FAST / 1000) - 1)
+
+// The reply to a 0xCD write (a non-zero second byte clears the counts
+// afterwards) is five little-endian words: timer0 ticks spent fast, ticks
+// spent slow, switches back up, and the longest and the last time taken
+// to get back up, in us.
+#define GOV_REPORTLEN 10
+
+#ifdef CLOCK_GOVERNOR
+extern volatile unsigned char gov_active;
+
+// Called by the I2C and UART receive handlers
+#define gov_activity() (gov_active = 1)
+
+void init_governor(void);
+// Called from main() with GIEH cleared, just before it sleeps
+void gov_idle(void);
+// Called from main() after it wakes
+void gov_run(void);
+// Counts timer0 ticks against the current clock
+void gov_ticks(unsigned char);
+unsigned char gov_report(unsigned char *);
+void gov_clear(void);
+#else
+#define init_governor()
+#define gov_activity()
+#define gov_idle()
+#define gov_run()
+#define gov_ticks(n)
+#endif
+
+#endif
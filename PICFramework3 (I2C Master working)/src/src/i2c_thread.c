@@ -0,0 +1,67 @@
+#include "maindefs.h"
+#include <stdio.h>
+#include "messages.h"
+#include "my_uart.h"
+#include "dready.h"
+#include "i2c_thread.h"
+
+// This is a "logical" thread that processes messages from the I2C handlers
+// It is not a "real" thread because there is only the single main thread
+// of execution on the PIC because we are not using an RTOS.
+//
+// The messages come on the high or the low priority queue, depending on
+// the priority the handlers run at (see my_i2c.c), so main() passes them
+// here from either one.
+
+int i2c_lthread(i2c_thread_struct *iptr, int msgtype, int length, unsigned char *msgbuffer) {
+    switch (msgtype) {
+        case MSGT_I2C_DATA:
+        case MSGT_I2C_DBG:
+        {
+            // Here is where you could handle debugging, if you wanted
+            // (msgbuffer[0] is the first byte received)
+            break;
+        };
+        case MSGT_I2C_MASTER_RECV_COMPLETE:
+        {
+            //msgbuffer[0] = length;
+            
+#ifdef SMBUS_BLOCK
+            // pass on what came after the count (nothing, if the
+            // sensor PIC had nothing new)
+            if ((length > 1) && (msgbuffer[0] > 0)) {
+#ifdef FRAME_DELTA
+                // the frame, not the delta, goes on to the PC
+                length = dready_decode(&msgbuffer[1],
+                        (msgbuffer[0] < length - 1) ? msgbuffer[0] : length - 1);
+                if (length > 0) {
+                    uart_trans(length, &msgbuffer[1]);
+                }
+#else
+                uart_trans(length - 1, &msgbuffer[1]);
+#endif
+            }
+#else
+            uart_trans(length, msgbuffer);
+#endif
+            dready_done();
+            
+            //i2c_master_send(1, 5, msg, 0x9E);
+            break;
+        };
+        case MSGT_I2C_MASTER_RECV_FAILED:
+        {
+            //unsigned char msg2[2] = {0xEE, 0xFF};
+            //i2c_master_send(1, 5, msg, 0x9E);
+            //LATBbits.LATB2 = 0;
+            dready_done();
+            break;
+        };
+        case MSGT_SLAVE_RCV:
+        {
+            uart_trans(length, msgbuffer);
+            break;
+        };
+    };
+    return (0);
+}
@@ -0,0 +1,6 @@
+typedef struct __i2c_thread_struct {
+    // "persistent" data for this "lthread" would go here
+    int data;
+} i2c_thread_struct;
+
+int i2c_lthread(i2c_thread_struct *,int,int,unsigned char*);
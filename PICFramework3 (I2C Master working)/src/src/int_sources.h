@@ -0,0 +1,92 @@
+#ifndef __int_sources_h
+#define __int_sources_h
+
+// Every interrupt source the framework uses, in one place.
+//
+// enable_interrupts() sets the priority and the initial enable of each
+// source from this table, and the two interrupt handlers in interrupts.c
+// are generated from it: each one tests, in table order, only the sources
+// of its own priority, and only when their enable bit is set (TXIF, for
+// one, stays set whenever the transmitter is idle).  Keep the sources in
+// order of how often they fire, busiest first.
+//
+// To move a source to the other priority, change its priority column.  For
+// I2C, change INT_I2C_PRIORITY -- routes.h follows it.
+
+#define INT_LOW 0
+#define INT_HIGH 1
+
+#define INT_I2C_PRIORITY INT_HIGH
+
+// Deferred work (defer.h) runs off the interrupt of a peripheral that is
+// left off, so that only software ever sets its flag
+#ifdef __USE18F2680
+#define DEFER_IP IPR2bits.TMR3IP
+#define DEFER_IE PIE2bits.TMR3IE
+#define DEFER_IF PIR2bits.TMR3IF
+#else
+#define DEFER_IP IPR2bits.CCP2IP
+#define DEFER_IE PIE2bits.CCP2IE
+#define DEFER_IF PIR2bits.CCP2IF
+#endif
+
+#ifdef I2C_DEFERRED
+#define INT_SOURCE_DEFER \
+    INT_SOURCE(INT_LOW, DEFER_IP, DEFER_IE, 1, \
+            DEFER_IF, 1, defer_run)
+#else
+#define INT_SOURCE_DEFER
+#endif
+
+// the A channels of the wheel encoders (encoder.h)
+#ifdef QUAD_ENCODERS
+#define INT_SOURCE_ENCODERS \
+    INT_SOURCE(INT_HIGH, INTCON3bits.INT1IP, INTCON3bits.INT1IE, 1, \
+            INTCON3bits.INT1IF, 1, enc_int1_handler) \
+    INT_SOURCE(INT_HIGH, INTCON3bits.INT2IP, INTCON3bits.INT2IE, 1, \
+            INTCON3bits.INT2IF, 1, enc_int2_handler)
+#else
+#define INT_SOURCE_ENCODERS
+#endif
+
+// the data-ready line from the sensor PIC, on the master (dready.h)
+#if defined(DATA_READY) && defined(I2CMASTER)
+#define INT_SOURCE_DREADY \
+    INT_SOURCE(INT_LOW, INTCON2bits.INT3IP, INTCON3bits.INT3IE, 1, \
+            INTCON3bits.INT3IF, 1, dready_int_handler)
+#else
+#define INT_SOURCE_DREADY
+#endif
+
+// bus collisions, on the master (my_i2c.c)
+#ifdef I2CMASTER
+#define INT_SOURCE_BCL \
+    INT_SOURCE(INT_I2C_PRIORITY, IPR2bits.BCLIP, PIE2bits.BCLIE, 1, \
+            PIR2bits.BCLIF, 1, i2c_bus_collision_handler)
+#else
+#define INT_SOURCE_BCL
+#endif
+
+// INT_SOURCE(priority, priority bit, enable bit, enabled at start,
+//            flag bit, clear the flag before the handler, handler)
+#define INT_SOURCES \
+    INT_SOURCE(INT_I2C_PRIORITY, IPR1bits.SSPIP, PIE1bits.SSPIE, 1, \
+            PIR1bits.SSPIF, 1, i2c_int_handler) \
+    INT_SOURCE_BCL \
+    INT_SOURCE_ENCODERS \
+    /* first of the low priority ones, as the I2C bus may be waiting */ \
+    INT_SOURCE_DEFER \
+    INT_SOURCE_DREADY \
+    INT_SOURCE(INT_LOW, IPR1bits.RCIP, PIE1bits.RCIE, 1, \
+            PIR1bits.RCIF, 1, uart_recv_int_handler) \
+    /* enabled by uart_trans() when there is something to send */ \
+    INT_SOURCE(INT_LOW, IPR1bits.TXIP, PIE1bits.TXIE, 0, \
+            PIR1bits.TXIF, 0, uart_trans_int_handler) \
+    INT_SOURCE(INT_HIGH, INTCON2bits.TMR0IP, INTCONbits.TMR0IE, 1, \
+            INTCONbits.TMR0IF, 1, timer0_int_handler) \
+    INT_SOURCE(INT_LOW, IPR1bits.TMR1IP, PIE1bits.TMR1IE, 1, \
+            PIR1bits.TMR1IF, 1, timer1_int_handler) \
+    INT_SOURCE(INT_LOW, IPR1bits.ADIP, PIE1bits.ADIE, 1, \
+            PIR1bits.ADIF, 1, adc_int_handler)
+
+#endif
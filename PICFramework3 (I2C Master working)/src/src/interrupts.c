@@ -2,6 +2,10 @@
 #include "interrupts.h"
 #include "user_interrupts.h"
 #include "messages.h"
+#include "int_sources.h"
+#include "defer.h"
+#include "encoder.h"
+#include "dready.h"
 
 
 //----------------------------------------------------------------------------
@@ -14,6 +18,13 @@
 
 void enable_interrupts() {
     // Peripheral interrupts can have their priority set to high or low
+    // -- both that and which ones start out enabled come from int_sources.h
+#define INT_SOURCE(prio, ipbit, iebit, enabled, ifbit, clear, handler) \
+    ipbit = (prio); \
+    iebit = (enabled);
+    INT_SOURCES
+#undef INT_SOURCE
+
     // enable high-priority interrupts and low-priority interrupts
     RCONbits.IPEN = 1;
     INTCONbits.GIEH = 1;
@@ -71,6 +82,17 @@ InterruptVectorHigh(void) {
             _endasm
 }
 #endif
+// One test per source in int_sources.h, for the sources of priority
+// INT_DISPATCH (the test on the priority is constant, so the others drop out)
+
+#define INT_SOURCE(prio, ipbit, iebit, enabled, ifbit, clear, handler) \
+    if (((prio) == INT_DISPATCH) && iebit && ifbit) { \
+        if (clear) { \
+            ifbit = 0; \
+        } \
+        handler(); \
+    }
+
 //----------------------------------------------------------------------------
 // High priority interrupt routine
 // this parcels out interrupts to individual handlers
@@ -84,26 +106,10 @@ interrupt
 void InterruptHandlerHigh() {
     // We need to check the interrupt flag of each enabled high-priority interrupt to
     // see which device generated this interrupt.  Then we can call the correct handler.
-
-    // check to see if we have an I2C interrupt
-    if (PIR1bits.SSPIF) {
-        // clear the interrupt flag
-        PIR1bits.SSPIF = 0;
-        // call the handler
-        
-        i2c_int_handler();
-        
-    }
-
-
-    // check to see if we have an interrupt on timer 0
-    if (INTCONbits.TMR0IF) {
-        INTCONbits.TMR0IF = 0; // clear this interrupt flag
-        // call whatever handler you want (this is "user" defined)
-        timer0_int_handler();
-    }
-
-    // here is where you would check other interrupt flags.
+    // (add new interrupt sources to int_sources.h)
+#define INT_DISPATCH INT_HIGH
+    INT_SOURCES
+#undef INT_DISPATCH
 
     // The *last* thing I do here is check to see if we can
     // allow the processor to go to sleep
@@ -124,31 +130,8 @@ interrupt low_priority
 #pragma interruptlow InterruptHandlerLow
 #endif
 void InterruptHandlerLow() {
-
-   if(PIR1bits.ADIF){
-        //clear interrupt flag
-        PIR1bits.ADIF = 0;
-        adc_int_handler();
-    }
-
-    // check to see if we have an interrupt on timer 1
-    if (PIR1bits.TMR1IF) {
-        PIR1bits.TMR1IF = 0; //clear interrupt flag
-        timer1_int_handler();
-        
-    }
-
-    if (PIR1bits.TXIF) {
-
-        uart_trans_int_handler();
-    }
-    // check to see if we have an interrupt on USART RX
-    if (PIR1bits.RCIF) {
-        PIR1bits.RCIF = 0; //clear interrupt flag
-        
-        uart_recv_int_handler();
-        
-    }
-
+#define INT_DISPATCH INT_LOW
+    INT_SOURCES
+#undef INT_DISPATCH
 }
 
@@ -0,0 +1,133 @@
+#include "maindefs.h"
+#ifndef __XC8
+#include <timers.h>
+#else
+#include <plib/timers.h>
+#endif
+#include "messages.h"
+#include "latency.h"
+
+#ifdef LATENCY_STATS
+
+// The stamps are a small ring that runs alongside the queue for the path.
+// The producer owns stamp_in and the consumer owns stamp_out, so (like the
+// queues) it is safe as long as there is one of each.  The producer pushes
+// its stamp *before* queueing the message, so the consumer can never see a
+// message without its stamp, and takes it back if the queue was full.
+// count, max and hist belong to the consumer and drops to the producer.
+static lat_stats lat[LAT_NUM_PATHS];
+
+void init_latency() {
+    unsigned char i;
+
+    for (i = 0; i < LAT_NUM_PATHS; i++) {
+        latency_clear(i);
+        lat[i].stamp_in = 0;
+        lat[i].stamp_out = 0;
+        lat[i].unstamped = 0;
+    }
+}
+
+void latency_start(unsigned char path) {
+    lat_stats *lp = &lat[path];
+    unsigned char next = (lp->stamp_in + 1) % LAT_STAMPS;
+
+    // (with the ring sized for the queue this cannot happen, but a full
+    // ring that wrapped would read as empty and put every stamp after it
+    // out of step with the messages)
+    if (next == lp->stamp_out) {
+        lp->unstamped = 1;
+        return;
+    }
+    lp->unstamped = 0;
+    lp->stamps[lp->stamp_in] = ReadTimer1();
+    lp->stamp_in = next;
+}
+
+void latency_drop(unsigned char path) {
+    lat_stats *lp = &lat[path];
+
+    if (!lp->unstamped) {
+        lp->stamp_in = (lp->stamp_in + LAT_STAMPS - 1) % LAT_STAMPS;
+    }
+    lp->drops++;
+}
+
+void latency_end(unsigned char path) {
+    lat_stats *lp = &lat[path];
+    unsigned int elapsed;
+    unsigned char bucket;
+
+    if (lp->stamp_out == lp->stamp_in) {
+        // not stamped (e.g. queued before the stats were cleared)
+        return;
+    }
+    elapsed = ReadTimer1() - lp->stamps[lp->stamp_out];
+    lp->stamp_out = (lp->stamp_out + 1) % LAT_STAMPS;
+
+    lp->count++;
+    if (elapsed > lp->max) {
+        lp->max = elapsed;
+    }
+    for (bucket = 0; elapsed != 0; bucket++) {
+        elapsed >>= 1;
+    }
+    lp->hist[bucket]++;
+}
+
+// upper bound of the bucket holding the target'th smallest latency
+
+static unsigned int latency_percentile(lat_stats *lp, unsigned int target) {
+    unsigned char bucket;
+    unsigned int seen = 0;
+
+    for (bucket = 0; bucket < LAT_BUCKETS - 1; bucket++) {
+        seen += lp->hist[bucket];
+        if (seen >= target) {
+            break;
+        }
+    }
+    return ((unsigned int) ((1UL << bucket) - 1));
+}
+
+// The counters may be updated by the other interrupt level while this
+// runs, so a report is only a snapshot -- good enough for statistics.
+
+unsigned char latency_report(unsigned char path, unsigned char *buf) {
+    lat_stats *lp;
+    unsigned int words[LAT_REPORTLEN / 2];
+    unsigned char i;
+
+    if (path >= LAT_NUM_PATHS) {
+        return (0);
+    }
+    lp = &lat[path];
+    words[0] = lp->count;
+    words[1] = lp->drops;
+    words[2] = latency_percentile(lp, (lp->count + 1) / 2);
+    words[3] = latency_percentile(lp, lp->count - lp->count / 100);
+    words[4] = lp->max;
+    for (i = 0; i < LAT_REPORTLEN / 2; i++) {
+        buf[2 * i] = words[i] & 0xFF;
+        buf[2 * i + 1] = words[i] >> 8;
+    }
+    return (LAT_REPORTLEN);
+}
+
+void latency_clear(unsigned char path) {
+    unsigned char i;
+    lat_stats *lp;
+
+    if (path >= LAT_NUM_PATHS) {
+        return;
+    }
+    lp = &lat[path];
+    lp->count = 0;
+    lp->drops = 0;
+    lp->max = 0;
+    for (i = 0; i < LAT_BUCKETS; i++) {
+        lp->hist[i] = 0;
+    }
+}
+
+#endif
@@ -0,0 +1,62 @@
+#ifndef __latency_h
+#define __latency_h
+
+#include "messages.h"
+
+// End-to-end latency accounting (enabled with LATENCY_STATS in maindefs.h)
+//
+// Each path is stamped with timer1 when a message enters it and again when
+// it leaves, and the difference goes into a log2 histogram.  Timer1 runs
+// free, so a latency is in timer1 counts (8 Tcy per count on the J50
+// builds) and anything over 65535 counts wraps.
+//
+// LAT_GATHER: UART sensor frame complete -> handed out in a 0xAB/0xBB reply
+//             (or copied into the register map, with I2C_REGMAP)
+// LAT_MOVE:   0xBA movement command accepted -> last byte out of the UART
+#define LAT_GATHER 0
+#define LAT_MOVE 1
+#define LAT_NUM_PATHS 2
+
+// bucket n holds latencies of less than 2^n counts (and at least 2^(n-1))
+#define LAT_BUCKETS 17
+
+// a stamp for every message the queue can hold, one for a message about
+// to be sent to a full queue, and a slot kept empty so a full ring can be
+// told from an empty one
+#define LAT_STAMPS (MSGQUEUELEN + 2)
+
+// The reply to a 0xCA stats request (path in the second byte, and a
+// non-zero third byte to clear the path afterwards) is five little-endian
+// words: completed, dropped, p50, p99, max.  p50 and p99 are the upper
+// bound of the histogram bucket they fall in.
+#define LAT_REPORTLEN 10
+
+#ifdef LATENCY_STATS
+typedef struct __lat_stats {
+    unsigned int count;
+    unsigned int drops;
+    unsigned int max;
+    unsigned int hist[LAT_BUCKETS];
+    unsigned int stamps[LAT_STAMPS];
+    unsigned char stamp_in;
+    unsigned char stamp_out;
+    unsigned char unstamped;
+} lat_stats;
+
+void init_latency(void);
+// Called by the producer just before it queues a message, and again if
+// the message could not be queued after all
+void latency_start(unsigned char);
+void latency_drop(unsigned char);
+// Called by the consumer for each message it takes off the path
+void latency_end(unsigned char);
+unsigned char latency_report(unsigned char, unsigned char *);
+void latency_clear(unsigned char);
+#else
+#define init_latency()
+#define latency_start(path) ((void)0)
+#define latency_drop(path) ((void)0)
+#define latency_end(path) ((void)0)
+#endif
+
+#endif
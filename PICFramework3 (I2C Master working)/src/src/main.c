@@ -13,9 +13,26 @@
 #include "messages.h"
 #include "my_uart.h"
 #include "my_i2c.h"
+#include "motor_cmd.h"
+#include "latency.h"
+#include "regmap.h"
+#include "routes.h"
+#include "frame_delta.h"
+#include "defer.h"
+#include "warm.h"
+#include "governor.h"
+#include "capture.h"
+#include "binlog.h"
+#include "fusion.h"
+#include "pid.h"
+#include "encoder.h"
+#include "odometry.h"
+#include "dready.h"
+#include "busmon.h"
 #include "uart_thread.h"
 #include "timer1_thread.h"
 #include "timer0_thread.h"
+#include "i2c_thread.h"
 
 
 
@@ -184,17 +201,32 @@ The PIC selected is not supported or the preprocessor directives are wrong.
 
 
 void main(void) {
-    char c;
     signed char length;
     unsigned char msgtype;
-    unsigned char last_reg_recvd;
     uart_comm uc;
     i2c_comm ic;
-    unsigned char msgbuffer[MSGLEN + 1];
-    unsigned char i;
-    uart_thread_struct uthread_data; // info for uart_lthread
+    unsigned char msgbuf;
+    unsigned char *msgbuffer;
     timer1_thread_struct t1thread_data; // info for timer1_lthread
     timer0_thread_struct t0thread_data; // info for timer0_lthread
+    i2c_thread_struct i2cthread_data; // info for i2c_lthread
+    unsigned char boot;
+
+    // timer1 is started first (it leaves RCON alone) so that warm_boot()
+    // can time the first reply from as near the reset as it can
+#ifdef __USE18F26J50
+    // MTJ added second argument for OpenTimer1()
+    OpenTimer1(TIMER_INT_ON & T1_SOURCE_FOSC_4 & T1_PS_1_8 & T1_16BIT_RW & T1_OSC1EN_OFF & T1_SYNC_EXT_OFF,0x0);
+#else
+#ifdef __USE18F46J50
+    OpenTimer1(TIMER_INT_ON & T1_SOURCE_FOSC_4 & T1_PS_1_8 & T1_16BIT_RW & T1_OSC1EN_OFF & T1_SYNC_EXT_OFF,0x0);
+#else
+    OpenTimer1(TIMER_INT_ON & T1_8BIT_RW & T1_PS_1_1 & T1_SOURCE_INT & T1_OSC1EN_OFF & T1_SYNC_EXT_OFF);
+#endif
+#endif
+
+    // find out why we (re)started before anything touches RCON
+    boot = warm_boot();
 
 #ifdef __USE18F2680
     OSCCON = 0xFC; // see datasheet
@@ -231,14 +263,32 @@ void main(void) {
 
     // initialize message queues before enabling any interrupts
     init_queues();
+    init_motor_cmds();
+    init_latency();
+    init_regmap();
+    init_frame_delta();
+    init_defer();
+    init_governor();
+    init_capture();
+    init_binlog();
+    init_fusion();
+    init_pid();
+    init_odometry();
+    init_busmon();
+    if (boot != WARM_COLD) {
+        warm_restore();
+    }
 
 #ifndef __USE18F26J50
+    // the output latches survive anything but a power-on reset, so after a
+    // warm restart the pins are left as they were
+    if (boot == WARM_COLD) {
+        LATB = 0x0;
+        PORTA = 0x0;
+        LATA = 0x0;
+    }
     // set direction for PORTB to output
     TRISB = 0x0;
-    LATB = 0x0;
-
-    PORTA = 0x0;
-    LATA = 0x0;
     TRISA = 0x0F;
 #endif
 
@@ -251,34 +301,12 @@ void main(void) {
             TRISA = 0x0F;	// set RA3-RA0 to inputs
      */
 
+    // the encoder and data-ready pins, now that the ports are set up
+    init_encoders();
+    init_dready();
+
     // initialize Timers
     OpenTimer0(TIMER_INT_ON & T0_8BIT & T0_SOURCE_INT & T0_PS_1_64);
-    
-#ifdef __USE18F26J50
-    // MTJ added second argument for OpenTimer1()
-    OpenTimer1(TIMER_INT_ON & T1_SOURCE_FOSC_4 & T1_PS_1_8 & T1_16BIT_RW & T1_OSC1EN_OFF & T1_SYNC_EXT_OFF,0x0);
-#else
-#ifdef __USE18F46J50
-    OpenTimer1(TIMER_INT_ON & T1_SOURCE_FOSC_4 & T1_PS_1_8 & T1_16BIT_RW & T1_OSC1EN_OFF & T1_SYNC_EXT_OFF,0x0);
-#else
-    OpenTimer1(TIMER_INT_ON & T1_8BIT_RW & T1_PS_1_1 & T1_SOURCE_INT & T1_OSC1EN_OFF & T1_SYNC_EXT_OFF);
-#endif
-#endif
-
-    // Decide on the priority of the enabled peripheral interrupts
-    // 0 is low, 1 is high
-
-    // ADC interrupt
-    IPR1bits.ADIP = 0;
-    PIE1bits.ADIE = 1;
-    // Timer1 interrupt
-    IPR1bits.TMR1IP = 0;
-    // USART RX interrupt
-    IPR1bits.RCIP = 0;
-    // USART TX interrupt
-    IPR1bits.TXIP = 0;
-    // I2C interrupt
-    IPR1bits.SSPIP = 1;
 
     // configure the hardware i2c device as a slave (0x9E -> 0x4F) or (0x9A -> 0x4D)
 #if 1
@@ -292,13 +320,13 @@ void main(void) {
     i2c_configure_master();
 #else
 #ifdef SENSORPIC
-    i2c_configure_slave(0x9E); // slave addr 4F
+    i2c_configure_slave(SENSORPIC_ADDR); // slave addr 4F
 #else
 #ifdef MOTORPIC
-    i2c_configure_slave(0xBE); // slave addr 5F
+    i2c_configure_slave(MOTORPIC_ADDR); // slave addr 5F
 #endif
 #ifdef ARMPIC
-    i2c_configure_slave(0x9E); //4F
+    i2c_configure_slave(SENSORPIC_ADDR); //4F
 #endif
 #endif
 #endif
@@ -316,9 +344,6 @@ void main(void) {
     for (;;);
 #endif
 
-    // must specifically enable the I2C interrupts
-    PIE1bits.SSPIE = 1;
-
     // configure the hardware USART device
 #ifdef __USE18F26J50
     Open1USART(USART_TX_INT_OFF & USART_RX_INT_ON & USART_ASYNCH_MODE & USART_EIGHT_BIT &
@@ -337,6 +362,7 @@ void main(void) {
 #endif
 
     // Peripheral interrupts can have their priority set to high or low
+    // (see int_sources.h), then
     // enable high-priority interrupts and low-priority interrupts
     enable_interrupts();
 
@@ -351,6 +377,9 @@ void main(void) {
     // on the PIC and then you must hook something up to that to view it.
     // It is also slow and is blocking, so it will perturb your code's operation
     // Here is how it looks: printf("Hello\r\n");
+    // With BINARY_LOG defined, log_event() (see binlog.h) is the
+    // non-blocking alternative.
+    log_event(LOG_BOOT, boot, 0);
 
       OpenADC(ADC_FOSC_16 & ADC_LEFT_JUST & ADC_2_TAD,
           ADC_CH1 & ADC_INT_OFF & ADC_VREFPLUS_VDD & ADC_VREFMINUS_VSS,
@@ -366,7 +395,6 @@ void main(void) {
     // that should get them.  Although the subroutines are not threads, but
     // they can be equated with the tasks in your task diagram if you
     // structure them properly.
-      unsigned char msg[2] = {0x01, 0x02};
      //i2c_master_send(1, 5, msg, 0x9E); // send length, recv length, message and address + r/w bit (0)
       //i2c_master_recv();
       
@@ -379,19 +407,23 @@ void main(void) {
         // messages queues has a message (this may put the processor into
         // an idle mode)
         block_on_To_msgqueues();
+        gov_run();
 
         // At this point, one or both of the queues has a message.  It
         // makes sense to check the high-priority messages first -- in fact,
         // you may only want to check the low-priority messages when there
         // is not a high priority message.  That is a design decision and
         // I haven't done it here.
-        length = ToMainHigh_recvmsg(MSGLEN, &msgtype, (void *) msgbuffer);
+        // The message is used in place in its pool buffer, which we own
+        // until it is freed at the bottom of the switch
+        length = ToMainHigh_recvbuf(&msgtype, &msgbuf);
         if (length < 0) {
             // no message, check the error code to see if it is concern
             if (length != MSGQUEUE_EMPTY) {
                 // This case be handled by your code.
             }
         } else {
+            msgbuffer = msg_buf(msgbuf);
             switch (msgtype) {
                 case MSGT_TIMER0:
                 {
@@ -400,31 +432,11 @@ void main(void) {
                 };
                 case MSGT_I2C_DATA:
                 case MSGT_I2C_DBG:
-                {
-                    // Here is where you could handle debugging, if you wanted
-                    // keep track of the first byte received for later use (if desired)
-                    last_reg_recvd = msgbuffer[0];
-                    break;
-                };
                 case MSGT_I2C_MASTER_RECV_COMPLETE:
-                {
-                    //msgbuffer[0] = length;
-                    
-                    uart_trans(length, msgbuffer);
-                    
-                    //i2c_master_send(1, 5, msg, 0x9E);
-                    break;
-                };
                 case MSGT_I2C_MASTER_RECV_FAILED:
-                {
-                    //unsigned char msg2[2] = {0xEE, 0xFF};
-                    //i2c_master_send(1, 5, msg, 0x9E);
-                    //LATBbits.LATB2 = 0;
-                    break;
-                };
                 case MSGT_SLAVE_RCV:
                 {
-                    uart_trans(length, msgbuffer);
+                    i2c_lthread(&i2cthread_data, msgtype, length, msgbuffer);
                     break;
                 };
                 default:
@@ -433,37 +445,70 @@ void main(void) {
                     break;
                 };
             };
+            msg_free(msgbuf);
         }
 
         // Check the low priority queue
-        length = ToMainLow_recvmsg(MSGLEN, &msgtype, (void *) msgbuffer);
+        length = ToMainLow_recvbuf(&msgtype, &msgbuf);
         if (length < 0) {
             // no message, check the error code to see if it is concern
             if (length != MSGQUEUE_EMPTY) {
                 // Your code should handle this situation
             }
         } else {
+            msgbuffer = msg_buf(msgbuf);
             switch (msgtype) {
                 case MSGT_TIMER1:
                 {
                     timer1_lthread(&t1thread_data, msgtype, length, msgbuffer);
                     break;
                 };
+                case MSGT_I2C_DATA:
+                case MSGT_I2C_DBG:
+                case MSGT_I2C_MASTER_RECV_COMPLETE:
+                case MSGT_I2C_MASTER_RECV_FAILED:
+                case MSGT_SLAVE_RCV:
+                {
+                    i2c_lthread(&i2cthread_data, msgtype, length, msgbuffer);
+                    break;
+                };
                 case MSGT_OVERRUN:
-                case MSGT_UART_DATA:
                 {
-                    LATBbits.LATB2 = 1;
-                    FromMainLow_sendmsg(length, MSGT_UART_DATA, msgbuffer);
-                    LATBbits.LATB2 = 0;
+                    // Complete UART frames are routed straight to the I2C
+                    // handler (see routes.h), so only errors arrive here
                     //uart_lthread(&uthread_data, msgtype, length, msgbuffer);
                     break;
                 };
+#ifdef DATA_READY
+                case MSGT_DATA_READY:
+                {
+                    // the sensor PIC has something for us
+                    dready_fetch();
+                    break;
+                };
+#endif
+#ifdef I2C_REGMAP
+                case MSGT_UART_DATA:
+                {
+                    // with the register map, frames come here first and
+                    // then go on to the 0xAB reply
+                    regmap_update(msgbuffer);
+                    latency_end(LAT_GATHER);
+                    if (route_sendbuf(ROUTE_SENSOR_DATA, length, MSGT_UART_DATA, msgbuf) == MSGSEND_OKAY) {
+                        // the route has the buffer now
+                        msgbuf = MSG_NOBUF;
+                        dready_set();
+                    }
+                    break;
+                };
+#endif
                 default:
                 {
                     // Your code should handle this error
                     break;
                 };
             };
+            msg_free(msgbuf);
         }
     }
 
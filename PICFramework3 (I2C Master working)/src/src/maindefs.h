@@ -44,6 +44,7 @@
 #define	MSGT_OVERRUN 30
 #define MSGT_UART_DATA 31
 #define MSGT_SLAVE_RCV 32
+#define MSGT_UART_SEND 33
 #define MSGT_I2C_DBG 41
 #define	MSGT_I2C_DATA 40
 #define MSGT_I2C_RQST 42
@@ -51,9 +52,106 @@
 #define MSGT_I2C_MASTER_SEND_FAILED 44
 #define MSGT_I2C_MASTER_RECV_COMPLETE 45
 #define MSGT_I2C_MASTER_RECV_FAILED 46
+#define MSGT_DATA_READY 47
 
 //I2C stuff
+// The role this build plays on the robot: ARMPIC, SENSORPIC, MOTORPIC or
+// I2CMASTER.  Defining one of them on the command line (-D) overrides the
+// default here, so every role can be built from the same tree.
+#if !defined(ARMPIC) && !defined(SENSORPIC) && !defined(MOTORPIC) && !defined(I2CMASTER)
 #define ARMPIC
+#endif
+
+// Slave addresses of the nodes (including the R/W bit)
+#define SENSORPIC_ADDR 0x9E
+#define MOTORPIC_ADDR 0xBE
+
+// Stop the periodic timer interrupts while main() is blocked and instead
+// program a single timer0 overflow for the next software deadline
+//#define TICKLESS_IDLE
+
+// Keep latency histograms for the gather and move paths (see latency.h)
+//#define LATENCY_STATS
+// Count events, transactions, handler time and errors in the I2C slave
+//#define I2C_SLAVE_STATS
+
+// Expect a CRC-8 after each UART frame (and drop the frame if it is wrong)
+// and send one after each I2C slave reply (see crc8.h)
+//#define FRAME_CRC
+
+// Use SMBus block transfers: every slave reply starts with a count of the
+// bytes that follow (0 when there is nothing, or for a command the slave
+// does not answer), and every write longer than just the command must be a
+// block write, [command, count, data...].  With the arguments the handlers
+// take, that is
+//     [0xAB, 1, seq]          the ack before a FRAME_DELTA read
+//     [0xAC, 1, seq]          fused sensors, if newer than seq
+//     [0xBA, 4 or 5, ...]     movement command [, sequence number]
+//     [0xBC, 1, mode]         odometry report
+//     [0xCA, 1 or 2, path [, clear]]    latency stats
+//     [0xCB, 1 or 2, page [, clear]]    slave stats
+//     [0xCD or 0xCF, 1, clear]          governor or motor loop stats
+//     [0xDA, 1, reg]          register map pointer
+// while a bare command, [0xAB], still needs no count.  The master's reads
+// of the sensor PIC take the count into account.  Off by default, so both
+// ends use plain transfers; it has to be on (or off) for all of the PICs.
+//#define SMBUS_BLOCK
+
+// Answer to four I2C addresses (sensor data, motor status, diagnostics and
+// the usual command address) using the MSSP address mask (J50 parts only)
+//#define I2C_VIRTUAL
+
+// Let the I2C master read the whole robot state in one burst out of a
+// register map (see regmap.h)
+//#define I2C_REGMAP
+
+// Send 0xAB replies as deltas against the last frame the master acked,
+// with a keyframe when needed (see frame_delta.h; needs SMBUS_BLOCK)
+//#define FRAME_DELTA
+
+// Split the I2C slave handler: the high priority interrupt only moves bytes
+// and the rest (replies, messages to main) runs at low priority (defer.h)
+//#define I2C_DEFERRED
+
+// Keep the last frame, motor command and restart counts across resets
+// other than power-on, and skip clearing the outputs (see warm.h)
+//#define WARM_RESTART
+
+// Drop to the internal oscillator while idle and go back to the PLL when
+// there is work (see governor.h; J50 parts, needs TICKLESS_IDLE)
+//#define CLOCK_GOVERNOR
+
+// Record I2C slave events and UART bytes with their timer1 counts, to be
+// dumped out of the UART on request (see capture.h)
+//#define TRAFFIC_CAPTURE
+
+// Send a binary event log out of the UART when it is otherwise idle (see
+// binlog.h and tools/logdecode.c)
+//#define BINARY_LOG
+
+// Reduce each sensor frame and the ADC reading to the nearest obstacle,
+// for the master to read with 0xAC (see fusion.h)
+//#define SENSOR_FUSION
+
+// Run speed loops on the timer1 interrupt that turn the targets in the
+// movement commands into drive values (see pid.h; MOTORPIC only)
+//#define MOTOR_PID
+
+// Count wheel encoder edges on INT1 and INT2 and add the positions and
+// speeds to the 0xBB reply (see encoder.h; J50 parts)
+//#define QUAD_ENCODERS
+
+// Keep a dead-reckoned pose from the encoders, for the master to read
+// with 0xBC (see odometry.h; needs QUAD_ENCODERS)
+//#define ODOMETRY
+
+// Raise a line when a slave has a sensor frame queued, and have the master
+// read only when it goes up instead of polling (see dready.h)
+//#define DATA_READY
+
+// Time and count the master's I2C transactions, per slave, and send the
+// totals out of the UART about once a second (see busmon.h)
+//#define I2C_BUS_MONITOR
 
 #endif
 
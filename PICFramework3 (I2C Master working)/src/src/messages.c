@@ -1,8 +1,26 @@
+#ifdef MSGQUEUE_HOST
+#include "messages.h"
+#include "routes.h"
+#include <string.h>
+// there are no interrupt levels to check on the host
+#undef DEBUG
+#define MSG_FLAG_LOAD(f) atomic_load_explicit(&(f), memory_order_acquire)
+#define MSG_FLAG_STORE(f, v) atomic_store_explicit(&(f), (v), memory_order_release)
+#define MSG_FLAG_CLAIM(f) (atomic_exchange_explicit(&(f), 1, memory_order_acquire) == 0)
+#else
 #include "maindefs.h"
 #include "interrupts.h"
 #include "messages.h"
+#include "tickless.h"
+#include "routes.h"
+#include "defer.h"
+#include "governor.h"
 #include <string.h>
 #include <delays.h>
+#define MSG_FLAG_LOAD(f) (f)
+#define MSG_FLAG_STORE(f, v) ((f) = (v))
+#define MSG_FLAG_CLAIM(f) ((f) == 0 ? ((f) = 1) : 0)
+#endif
 
 // The key to making this code safe for interrupts is that
 // each queue is filled by only one writer and read by one reader.
@@ -11,90 +29,170 @@
 // FromMainQueueLow: Writer is main(), Reader is a low priority interrupt
 // FromMainQueueHigh: Writer is main(), Reader is a high priority interrupt
 
+// The message data itself lives in a pool of buffers shared by every queue;
+// a queue slot only carries the handle of its buffer.  A buffer belongs to
+// whoever allocated it until it is sent, then to the queue, and then to
+// whoever received it, who must give it back with msg_free().  Allocation
+// is the only step that several interrupt levels can race on, so it is done
+// with the high priority interrupts masked.
+
+static unsigned char MsgPool[MSGPOOLLEN][MSGLEN];
+static msg_flag MsgPool_inuse[MSGPOOLLEN];
+static msg_count MsgPool_empty;
+
+static void init_msg_pool(void) {
+    unsigned char i;
+
+    MsgPool_empty = 0;
+    for (i = 0; i < MSGPOOLLEN; i++) {
+        MSG_FLAG_STORE(MsgPool_inuse[i], 0);
+    }
+}
+
+unsigned char msg_alloc() {
+    unsigned char i;
+#ifndef MSGQUEUE_HOST
+    unsigned char gieh = INTCONbits.GIEH;
+
+    INTCONbits.GIEH = 0;
+#endif
+    for (i = 0; i < MSGPOOLLEN; i++) {
+        if (MSG_FLAG_CLAIM(MsgPool_inuse[i])) {
+            break;
+        }
+    }
+    if (i == MSGPOOLLEN) {
+        MsgPool_empty++;
+    }
+#ifndef MSGQUEUE_HOST
+    INTCONbits.GIEH = gieh;
+#endif
+    if (i == MSGPOOLLEN) {
+        return (MSG_NOBUF);
+    }
+    return (i);
+}
+
+unsigned int msg_pool_empty() {
+    return (MsgPool_empty);
+}
+
+void msg_free(unsigned char buf) {
+    if (buf != MSG_NOBUF) {
+        MSG_FLAG_STORE(MsgPool_inuse[buf], 0);
+    }
+}
+
+unsigned char *msg_buf(unsigned char buf) {
+    if (buf == MSG_NOBUF) {
+        return ((unsigned char *) 0);
+    }
+    return (MsgPool[buf]);
+}
+
 void init_queue(msg_queue *qptr) {
     unsigned char i;
 
     qptr->cur_write_ind = 0;
     qptr->cur_read_ind = 0;
     for (i = 0; i < MSGQUEUELEN; i++) {
-        qptr->queue[i].full = 0;
+        MSG_FLAG_STORE(qptr->queue[i].full, 0);
     }
 }
 
-signed char send_msg(msg_queue *qptr, unsigned char length, unsigned char msgtype, void *data) {
-    unsigned char slot;
-    //unsigned char *msgptr = (unsigned char *) data;
+// hand a buffer (already filled in) over to a queue
+
+signed char send_buf(msg_queue *qptr, unsigned char length, unsigned char msgtype, unsigned char buf) {
     msg *qmsg;
-    size_t tlength = length;
 
 #ifdef DEBUG
     if (length > MSGLEN) {
         return (MSGBAD_LEN);
-    } else if (length < 0) {
-        return (MSGBAD_LEN);
     }
 #endif
 
-    slot = qptr->cur_write_ind;
-    qmsg = &(qptr->queue[slot]);
+    qmsg = &(qptr->queue[qptr->cur_write_ind]);
     // if the slot isn't empty, then we should return
-    if (qmsg->full != 0) {
+    if (MSG_FLAG_LOAD(qmsg->full) != 0) {
         return (MSGQUEUE_FULL);
     }
 
     // now fill in the message
     qmsg->length = length;
     qmsg->msgtype = msgtype;
-
-    /*
-            for (i=0;i<length;i++) {
-                    qptr->queue[slot].data[i] = msgptr[i];
-            }
-     */
-
-    memcpy(qmsg->data, data, tlength);
+    qmsg->buf = buf;
     qptr->cur_write_ind = (qptr->cur_write_ind + 1) % MSGQUEUELEN;
 
     // This *must* be done after the message is completely inserted
-    qmsg->full = 1;
+    MSG_FLAG_STORE(qmsg->full, 1);
     return (MSGSEND_OKAY);
 }
 
-signed char recv_msg(msg_queue *qptr, unsigned char maxlength, unsigned char *msgtype, void *data) {
-    unsigned char slot;
-    //unsigned char	i;
-    //unsigned char	retlength;
-    //unsigned char *msg = (unsigned char *) data;
+// take the next buffer off a queue -- the caller now owns it
+
+signed char recv_buf(msg_queue *qptr, unsigned char *msgtype, unsigned char *buf) {
     msg *qmsg;
-    size_t tlength;
+    signed char length;
 
     // check to see if anything is available
-    slot = qptr->cur_read_ind;
-    qmsg = &(qptr->queue[slot]);
-    if (qmsg->full == 1) {
-        // not enough room in the buffer provided
-        if (qmsg->length > maxlength) {
-            return (MSGBUFFER_TOOSMALL);
-        }
-        // now actually copy the message
-        tlength = qmsg->length;
-        memcpy(data, qmsg->data, tlength);
-        /*
-        for (i=0;i<qmsg->length;i++) {
-                ((unsigned char *) data)[i] = qptr->queue[slot].data[i];
-        }
-         */
-        qptr->cur_read_ind = (qptr->cur_read_ind + 1) % MSGQUEUELEN;
-        //retlength = qptr->queue[slot].length;
-        (*msgtype) = qmsg->msgtype;
-        // this must be done after the message is completely extracted
-        qmsg->full = 0;
-        return (tlength);
-    } else {
+    qmsg = &(qptr->queue[qptr->cur_read_ind]);
+    if (MSG_FLAG_LOAD(qmsg->full) != 1) {
         return (MSGQUEUE_EMPTY);
     }
+    length = qmsg->length;
+    (*msgtype) = qmsg->msgtype;
+    (*buf) = qmsg->buf;
+    qptr->cur_read_ind = (qptr->cur_read_ind + 1) % MSGQUEUELEN;
+    // this must be done after the message is completely extracted
+    MSG_FLAG_STORE(qmsg->full, 0);
+    return (length);
 }
-#ifndef __XC8
+
+// The copying versions: the data is copied into a buffer from the pool on
+// the way in and back out (freeing the buffer) on the way out.
+
+signed char send_msg(msg_queue *qptr, unsigned char length, unsigned char msgtype, void *data) {
+    unsigned char buf = MSG_NOBUF;
+    signed char retval;
+
+    // don't take a buffer if there is nowhere to put it
+    if (MSG_FLAG_LOAD(qptr->queue[qptr->cur_write_ind].full) != 0) {
+        return (MSGQUEUE_FULL);
+    }
+    if (length > 0) {
+        buf = msg_alloc();
+        if (buf == MSG_NOBUF) {
+            return (MSGPOOL_EMPTY);
+        }
+        memcpy(MsgPool[buf], data, (size_t) length);
+    }
+    retval = send_buf(qptr, length, msgtype, buf);
+    if (retval != MSGSEND_OKAY) {
+        msg_free(buf);
+    }
+    return (retval);
+}
+
+signed char recv_msg(msg_queue *qptr, unsigned char maxlength, unsigned char *msgtype, void *data) {
+    msg *qmsg;
+    unsigned char buf;
+    signed char length;
+
+    qmsg = &(qptr->queue[qptr->cur_read_ind]);
+    // not enough room in the buffer provided (leave the message queued)
+    if ((MSG_FLAG_LOAD(qmsg->full) == 1) && (qmsg->length > maxlength)) {
+        return (MSGBUFFER_TOOSMALL);
+    }
+    length = recv_buf(qptr, msgtype, &buf);
+    if (length > 0) {
+        memcpy(data, MsgPool[buf], (size_t) length);
+    }
+    if (length >= 0) {
+        msg_free(buf);
+    }
+    return (length);
+}
+#if !defined(__XC8) && !defined(MSGQUEUE_HOST)
 #pragma udata msgqueue1
 #endif
 
@@ -117,7 +215,25 @@ signed char ToMainLow_recvmsg(unsigned char maxlength, unsigned char *msgtype, v
 #endif
     return (recv_msg(&ToMainLow_MQ, maxlength, msgtype, data));
 }
-#ifndef __XC8
+
+signed char ToMainLow_recvbuf(unsigned char *msgtype, unsigned char *buf) {
+#ifdef DEBUG
+    if (!in_main()) {
+        return (MSG_NOT_IN_MAIN);
+    }
+#endif
+    return (recv_buf(&ToMainLow_MQ, msgtype, buf));
+}
+
+signed char ToMainLow_sendbuf(unsigned char length, unsigned char msgtype, unsigned char buf) {
+#ifdef DEBUG
+    if (!in_low_int()) {
+        return (MSG_NOT_IN_LOW);
+    }
+#endif
+    return (send_buf(&ToMainLow_MQ, length, msgtype, buf));
+}
+#if !defined(__XC8) && !defined(MSGQUEUE_HOST)
 #pragma udata msgqueue2
 #endif
 
@@ -141,7 +257,16 @@ signed char ToMainHigh_recvmsg(unsigned char maxlength, unsigned char *msgtype,
     return (recv_msg(&ToMainHigh_MQ, maxlength, msgtype, data));
 }
 
-#ifndef __XC8
+signed char ToMainHigh_recvbuf(unsigned char *msgtype, unsigned char *buf) {
+#ifdef DEBUG
+    if (!in_main()) {
+        return (MSG_NOT_IN_MAIN);
+    }
+#endif
+    return (recv_buf(&ToMainHigh_MQ, msgtype, buf));
+}
+
+#if !defined(__XC8) && !defined(MSGQUEUE_HOST)
 #pragma udata msgqueue3
 #endif
 
@@ -165,7 +290,7 @@ signed char FromMainLow_recvmsg(unsigned char maxlength, unsigned char *msgtype,
     return (recv_msg(&FromMainLow_MQ, maxlength, msgtype, data));
 }
 
-#ifndef __XC8
+#if !defined(__XC8) && !defined(MSGQUEUE_HOST)
 #pragma udata msgqueue4
 #endif
 
@@ -189,16 +314,108 @@ signed char FromMainHigh_recvmsg(unsigned char maxlength, unsigned char *msgtype
     return (recv_msg(&FromMainHigh_MQ, maxlength, msgtype, data));
 }
 
+#if !defined(__XC8) && !defined(MSGQUEUE_HOST)
+#pragma udata msgqueue5
+#endif
+
+static msg_queue Route_MQ[NUM_ROUTES];
+
+#ifdef DEBUG
+#define ROUTE(name, writer, reader) writer,
+static const unsigned char Route_writer[NUM_ROUTES] = {ROUTES};
+#undef ROUTE
+#define ROUTE(name, writer, reader) reader,
+static const unsigned char Route_reader[NUM_ROUTES] = {ROUTES};
+#undef ROUTE
+
+static signed char route_check_context(unsigned char context) {
+    if (context == ROUTE_MAIN) {
+        return (in_main() ? 0 : MSG_NOT_IN_MAIN);
+    } else if (context == ROUTE_LOW) {
+        return (in_low_int() ? 0 : MSG_NOT_IN_LOW);
+    } else {
+        return (in_high_int() ? 0 : MSG_NOT_IN_HIGH);
+    }
+}
+#endif
+
+signed char route_sendmsg(unsigned char route, unsigned char length, unsigned char msgtype, void *data) {
+#ifdef DEBUG
+    signed char retval = route_check_context(Route_writer[route]);
+    if (retval < 0) {
+        return (retval);
+    }
+#endif
+    return (send_msg(&Route_MQ[route], length, msgtype, data));
+}
+
+signed char route_sendbuf(unsigned char route, unsigned char length, unsigned char msgtype, unsigned char buf) {
+#ifdef DEBUG
+    signed char retval = route_check_context(Route_writer[route]);
+    if (retval < 0) {
+        return (retval);
+    }
+#endif
+    return (send_buf(&Route_MQ[route], length, msgtype, buf));
+}
+
+signed char route_recvmsg(unsigned char route, unsigned char maxlength, unsigned char *msgtype, void *data) {
+#ifdef DEBUG
+    signed char retval = route_check_context(Route_reader[route]);
+    if (retval < 0) {
+        return (retval);
+    }
+#endif
+    return (recv_msg(&Route_MQ[route], maxlength, msgtype, data));
+}
+
+signed char route_recvbuf(unsigned char route, unsigned char *msgtype, unsigned char *buf) {
+#ifdef DEBUG
+    signed char retval = route_check_context(Route_reader[route]);
+    if (retval < 0) {
+        return (retval);
+    }
+#endif
+    return (recv_buf(&Route_MQ[route], msgtype, buf));
+}
+
+// number of messages waiting on a route
+
+unsigned char route_depth(unsigned char route) {
+    unsigned char i;
+    unsigned char depth = 0;
+
+    for (i = 0; i < MSGQUEUELEN; i++) {
+        depth += MSG_FLAG_LOAD(Route_MQ[route].queue[i].full);
+    }
+    return (depth);
+}
+
 static unsigned char MQ_Main_Willing_to_block;
+static unsigned int MQ_Wakeups;
 
 void init_queues() {
+    unsigned char i;
+
     MQ_Main_Willing_to_block = 0;
+    MQ_Wakeups = 0;
+    init_msg_pool();
     init_queue(&ToMainLow_MQ);
     init_queue(&ToMainHigh_MQ);
     init_queue(&FromMainLow_MQ);
     init_queue(&FromMainHigh_MQ);
+    for (i = 0; i < NUM_ROUTES; i++) {
+        init_queue(&Route_MQ[i]);
+    }
 }
 
+// check if message available
+
+unsigned char check_msg(msg_queue *qptr) {
+    return (MSG_FLAG_LOAD(qptr->queue[qptr->cur_read_ind].full));
+}
+
+#ifndef MSGQUEUE_HOST
 void enter_sleep_mode(void) {
     // Here we set up the clock to go into IDLE on sleep
     OSCCONbits.IDLEN = 1; // set to idle on sleep
@@ -213,17 +430,21 @@ void enter_sleep_mode(void) {
     SLEEP
     #endasm
     #endif
+    MQ_Wakeups++;
 }
 
-// check if message available
-
-unsigned char check_msg(msg_queue *qptr) {
-    return (qptr->queue[qptr->cur_read_ind].full);
+unsigned int sleep_wakeups() {
+    return (MQ_Wakeups);
 }
 
 // This should only be called from a High Priority Interrupt
 
 void SleepIfOkay() {
+#ifdef TICKLESS_IDLE
+    // main() sleeps by itself, with the timers set up for it, and a sleep
+    // in here would be woken by every timer0 tick
+    return;
+#endif
     // we won't sleep if the main isn't willing to block
     if (MQ_Main_Willing_to_block == 0) {
         return;
@@ -248,6 +469,12 @@ void SleepIfOkay() {
     if (check_msg(&ToMainLow_MQ)) {
         return;
     }
+#ifdef I2C_DEFERRED
+    // nor if there is work still to do at low priority
+    if (defer_waiting()) {
+        return;
+    }
+#endif
     enter_sleep_mode();
 }
 
@@ -276,9 +503,25 @@ void block_on_To_msgqueues() {
 #endif
             return;
         }
+#ifdef TICKLESS_IDLE
+        // With GIEH clear no handler can run, so nothing can be put into
+        // the queues between this check and the SLEEP -- an interrupt that
+        // is already pending just makes the SLEEP fall through.  The handler
+        // runs as soon as GIEH is set again.
+        INTCONbits.GIEH = 0;
+        if (!check_msg(&ToMainHigh_MQ) && !check_msg(&ToMainLow_MQ)) {
+            gov_idle();
+            tickless_enter_idle();
+            enter_sleep_mode();
+            tickless_exit_idle();
+        }
+        INTCONbits.GIEH = 1;
+#else
         Delay1KTCYx(10);
+#endif
 #ifdef __USE18F2680
         LATBbits.LATB3 = !LATBbits.LATB3;
 #endif
     }
-}
\ No newline at end of file
+}
+#endif
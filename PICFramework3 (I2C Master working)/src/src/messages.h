@@ -7,20 +7,50 @@
 // The maximum number of messages in a single queue
 #define MSGQUEUELEN 5
 
+// Defining MSGQUEUE_HOST builds the queues (and nothing PIC-specific) for
+// a C11 host, e.g. a Linux process where the writer and reader are threads
+// on different cores.  There the "full" flag is an atomic that is stored
+// with release and loaded with acquire ordering, which is what the
+// single-writer/single-reader rule in messages.c relies on, and the two
+// indices are kept on separate cache lines from each other.
+#ifdef MSGQUEUE_HOST
+#include <stdatomic.h>
+typedef atomic_uchar msg_flag;
+typedef atomic_uint msg_count;
+#ifndef MSG_CACHE_ALIGN
+#define MSG_CACHE_ALIGN _Alignas(64)
+#endif
+#else
+typedef unsigned char msg_flag;
+typedef unsigned int msg_count;
+#define MSG_CACHE_ALIGN
+#endif
+
+// The number of message buffers shared by all of the queues.  There are
+// fewer than there are queue slots (MSGQUEUELEN for each of the four queues
+// and each route, 30 in all) to save RAM, since the queues are not all full
+// at once.  If they ever are, a send fails with MSGPOOL_EMPTY -- the
+// message is dropped just as if its queue were full -- and msg_pool_empty()
+// counts it.
+#define MSGPOOLLEN 16
+// The handle of "no buffer" (used by messages of length 0)
+#define MSG_NOBUF 0xFF
+
 typedef struct __msg {
-    unsigned char full;
+    msg_flag full;
     unsigned char length;
     unsigned char msgtype;
-    unsigned char data[MSGLEN];
+    unsigned char buf;
 } msg;
 
 typedef struct __msg_queue {
     msg queue[MSGQUEUELEN];
-    unsigned char cur_write_ind;
-    unsigned char cur_read_ind;
+    MSG_CACHE_ALIGN unsigned char cur_write_ind;
+    MSG_CACHE_ALIGN unsigned char cur_read_ind;
 } msg_queue;
 
-unsigned int uartTimeOut;
+// timer0 ticks since the UART frame timeout last expired (in my_uart.c)
+extern unsigned int uartTimeOut;
 
 // Error Codes
 // Too many messages in the queue
@@ -39,11 +69,37 @@ unsigned int uartTimeOut;
 #define MSG_NOT_IN_HIGH -6
 // This call must be made from the "main()" thread
 #define MSG_NOT_IN_MAIN -7
+// Every buffer in the message pool is in use
+#define MSGPOOL_EMPTY -8
 
 // This MUST be called before anything else in messages and should
 // be called before interrupts are enabled
 void init_queues(void);
 
+// The generic queue routines behind the named queues below.  They may be
+// used for other queues as long as each one still has a single writer and
+// a single reader.
+void init_queue(msg_queue *);
+signed char send_msg(msg_queue *,unsigned char,unsigned char,void *);
+signed char recv_msg(msg_queue *,unsigned char,unsigned char *,void *);
+unsigned char check_msg(msg_queue *);
+
+// Message buffers:
+// The data of every queued message is held in a buffer from a shared pool
+// and the queues only pass around its one-byte handle.  The *_sendmsg and
+// *_recvmsg calls copy into and out of a buffer for you.  To avoid those
+// copies, a producer can msg_alloc() a buffer, fill in msg_buf() and pass
+// the handle to send_buf() (or one of the *_sendbuf calls), and a consumer can take the handle with
+// recv_buf() (or one of the *_recvbuf calls), use the data in place and
+// then msg_free() it.  Whoever holds a handle owns the buffer.
+unsigned char msg_alloc(void);
+void msg_free(unsigned char);
+// Number of times msg_alloc() found every buffer in use (wraps around)
+unsigned int msg_pool_empty(void);
+unsigned char *msg_buf(unsigned char);
+signed char send_buf(msg_queue *,unsigned char,unsigned char,unsigned char);
+signed char recv_buf(msg_queue *,unsigned char *,unsigned char *);
+
 // This is called from a high priority interrupt to decide if the
 // processor may sleep. It is currently called in interrupts.c
 void SleepIfOkay(void);
@@ -52,12 +108,18 @@ void SleepIfOkay(void);
 // until a message is received on one of the two incoming queues
 void block_on_To_msgqueues(void);
 
+// Number of times the processor has been woken from sleep (wraps around);
+// sample it twice a known time apart to get wakeups/second
+unsigned int sleep_wakeups(void);
+
 // Queue:
 // The "ToMainLow" queue is a message queue from low priority
 // interrupt handlers to the "main()" thread.  The send is called
 // in the interrupt handlers and the receive from "main()"
 signed char ToMainLow_sendmsg(unsigned char,unsigned char,void *);
 signed char ToMainLow_recvmsg(unsigned char,unsigned char *,void *);
+signed char ToMainLow_recvbuf(unsigned char *,unsigned char *);
+signed char ToMainLow_sendbuf(unsigned char,unsigned char,unsigned char);
 
 // Queue:
 // The "ToMainHigh" queue is a message queue from high priority
@@ -65,6 +127,7 @@ signed char ToMainLow_recvmsg(unsigned char,unsigned char *,void *);
 // in the interrupt handlers and the receive from "main()"
 signed char ToMainHigh_sendmsg(unsigned char,unsigned char,void *);
 signed char ToMainHigh_recvmsg(unsigned char,unsigned char *,void *);
+signed char ToMainHigh_recvbuf(unsigned char *,unsigned char *);
 
 // Queue:
 // The "FromMainLow" queue is a message queue from the "main()"
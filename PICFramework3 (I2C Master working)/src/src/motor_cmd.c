@@ -0,0 +1,76 @@
+#include "maindefs.h"
+#include "messages.h"
+#include "routes.h"
+#include "motor_cmd.h"
+#include "latency.h"
+#include "warm.h"
+#include "binlog.h"
+#include "pid.h"
+
+// The commands travel on ROUTE_MOTOR_CMD, with the msgtype field of each
+// message carrying its sequence number.
+static unsigned char inflight;
+static unsigned char inflight_seq;
+static unsigned char applied_seq;
+
+void init_motor_cmds() {
+    inflight = 0;
+    inflight_seq = 0;
+    applied_seq = 0;
+}
+
+signed char motor_cmd_post(unsigned char seq, unsigned char *cmd) {
+    signed char retval;
+
+#ifdef MOTOR_PID
+    // the command sets the targets of the speed loops, which send it on
+    pid_setpoint(cmd);
+    applied_seq = seq;
+    return (MSGSEND_OKAY);
+#endif
+    latency_start(LAT_MOVE);
+    retval = route_sendmsg(ROUTE_MOTOR_CMD, MOTOR_CMDLEN, seq, (void *) cmd);
+    if (retval == MSGSEND_OKAY) {
+        // get the transmit interrupt going if it isn't already
+        PIE1bits.TX1IE = 1;
+    } else {
+        latency_drop(LAT_MOVE);
+        log_event(LOG_MOTOR_FULL, seq, 0);
+    }
+    return (retval);
+}
+
+signed char motor_cmd_next(unsigned char *cmd) {
+    signed char length;
+
+    if (inflight) {
+        applied_seq = inflight_seq;
+        inflight = 0;
+        latency_end(LAT_MOVE);
+        warm_save_motor(applied_seq);
+    }
+    length = route_recvmsg(ROUTE_MOTOR_CMD, MOTOR_CMDLEN, &inflight_seq, (void *) cmd);
+    if (length > 0) {
+        inflight = 1;
+    }
+    return (length);
+}
+
+void motor_cmd_restore(unsigned char seq) {
+    applied_seq = seq;
+}
+
+unsigned char motor_cmd_applied() {
+    return (applied_seq);
+}
+
+unsigned char motor_cmd_depth() {
+    unsigned char gieh = INTCONbits.GIEH;
+    unsigned char depth;
+
+    // the transmit handler moves a command from the route to inflight
+    INTCONbits.GIEH = 0;
+    depth = route_depth(ROUTE_MOTOR_CMD) + inflight;
+    INTCONbits.GIEH = gieh;
+    return (depth);
+}
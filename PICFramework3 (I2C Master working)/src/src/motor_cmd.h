@@ -0,0 +1,38 @@
+#ifndef __motor_cmd_h
+#define __motor_cmd_h
+
+// Movement commands (0xBA) are queued here by the I2C handler and sent out
+// to the motor controller by the UART transmit handler, one after another,
+// so the master can stream commands without waiting for each one.
+//
+// A movement command is written as
+//     0xBA, 4 bytes of payload [, sequence number]
+// and the first MOTOR_CMDLEN bytes are forwarded over the UART unchanged.
+// The reply to it is
+//     MOTOR_ACK_OK or MOTOR_ACK_FULL, last applied sequence, queue depth
+// where a command counts as applied once its last byte has left the UART
+// and the depth includes the command currently being sent.
+
+#define MOTOR_CMDLEN 5
+#define MOTOR_ACK_OK 0x02
+#define MOTOR_ACK_FULL 0x03
+
+// must be called before interrupts are enabled (after init_queues())
+void init_motor_cmds(void);
+
+// Called from the high priority (I2C) interrupt handler.  Returns
+// MSGSEND_OKAY, or MSGQUEUE_FULL if the command was dropped.
+signed char motor_cmd_post(unsigned char, unsigned char *);
+
+// Called from the low priority (UART transmit) interrupt handler once the
+// previous command is out.  Copies the next command into the buffer and
+// returns its length, or MSGQUEUE_EMPTY.
+signed char motor_cmd_next(unsigned char *);
+
+// after a warm restart (see warm.h), before interrupts are enabled
+void motor_cmd_restore(unsigned char);
+
+unsigned char motor_cmd_applied(void);
+unsigned char motor_cmd_depth(void);
+
+#endif
@@ -2,13 +2,78 @@
 #include "user_interrupts.h"
 #ifndef __XC8
 #include <i2c.h>
+#include <timers.h>
 #else
 #include <plib/i2c.h>
+#include <plib/timers.h>
 #endif
 #include "my_i2c.h"
+#include "my_uart.h"
+#include "routes.h"
+#include "motor_cmd.h"
+#include "latency.h"
+#include "crc8.h"
+#include "regmap.h"
+#include "frame_delta.h"
+#include "defer.h"
+#include "warm.h"
+#include "governor.h"
+#include "capture.h"
+#include "binlog.h"
+#include "fusion.h"
+#include "pid.h"
+#include "odometry.h"
+#include "dready.h"
+#include "busmon.h"
 
 static i2c_comm *ic_ptr;
 
+#ifdef I2C_SLAVE_STATS
+static i2c_slave_stats i2c_stats;
+#endif
+
+// Messages to main() go on the queue of the priority the handler runs at,
+// the same way routes.h picks ROUTE_I2C: the master's handlers follow
+// INT_I2C_PRIORITY, and the slave's messages also move to low priority
+// when they are sent from i2c_slave_work() (I2C_DEFERRED).
+#if INT_I2C_PRIORITY == INT_HIGH
+#define i2c_master_tomain ToMainHigh_sendmsg
+#else
+#define i2c_master_tomain ToMainLow_sendmsg
+#endif
+#if ROUTE_I2C == ROUTE_HIGH
+#define i2c_slave_tomain ToMainHigh_sendmsg
+#else
+#define i2c_slave_tomain ToMainLow_sendmsg
+#endif
+
+#ifdef I2C_VIRTUAL
+// the temperature sensor shares the bus at 0x9A
+#if ((SENSORPIC_ADDR & I2C_DEV_ADDRMASK) == (0x9A & I2C_DEV_ADDRMASK)) || \
+    ((MOTORPIC_ADDR & I2C_DEV_ADDRMASK) == (0x9A & I2C_DEV_ADDRMASK))
+#error "I2C_DEV_ADDRMASK would make a slave answer for the temperature sensor"
+#endif
+
+// the command a read from each virtual device stands for
+static const unsigned char i2c_dev_cmds[I2C_NUM_DEVS] = {
+    0xAB, // I2C_DEV_SENSOR
+    0xBB, // I2C_DEV_MOTOR
+    0xCB, // I2C_DEV_DIAG
+    0x00  // I2C_DEV_CMD (not used)
+};
+#endif
+
+// record an error in the slave state machine
+
+static void i2c_slave_error(unsigned char code) {
+    ic_ptr->error_count++;
+    ic_ptr->error_code = code;
+    log_event(LOG_I2C_ERROR, code, ic_ptr->status);
+#ifdef I2C_SLAVE_STATS
+    i2c_stats.errors[code - I2C_ERR_OVERRUN]++;
+#endif
+}
+
 // Configure for I2C Master mode -- the variable "slave_addr" should be stored in
 //   i2c_comm (as pointed to by ic_ptr) for later use.
 
@@ -21,7 +86,7 @@ void i2c_configure_master() {
     
     TRISCbits.TRISC3 = 1; // set SCL and SDA as outputs
     TRISCbits.TRISC4 = 1;
-    SSPADD = 29;     // sets baud rate to 100KHz
+    SSPADD = I2C_MASTER_SSPADD;     // sets baud rate to 400KHz
 
     
     SSPCON1bits.SSPM = 0x8; // SSPM = b1000
@@ -53,6 +118,7 @@ unsigned char i2c_master_send(unsigned char sendlength, unsigned char recvlength
     ic_ptr->status = I2C_WRITE_ADDR;
     ic_ptr->outbufind = 0;
 
+    busmon_start(slave_addr);
     SSPCON2bits.SEN = 1; // send start bit
 
     return(0);
@@ -90,12 +156,32 @@ unsigned char i2c_master_recv(unsigned char length) {
 }
 
 void start_i2c_slave_reply(unsigned char length, unsigned char *msg) {
+    unsigned char i;
+#ifdef FRAME_CRC
+    unsigned char crc = CRC8_INIT;
+#endif
 
-    for (ic_ptr->outbuflen = 0; ic_ptr->outbuflen < length; ic_ptr->outbuflen++) {
-        ic_ptr->outbuffer[ic_ptr->outbuflen] = msg[ic_ptr->outbuflen];
+    ic_ptr->outbuflen = 0;
+#ifdef SMBUS_BLOCK
+    // room for the byte count (filled in below)
+    ic_ptr->outbuflen++;
+#endif
+    for (i = 0; i < length; i++) {
+        ic_ptr->outbuffer[ic_ptr->outbuflen++] = msg[i];
+#ifdef FRAME_CRC
+        crc = crc8_update(crc, msg[i]);
+#endif
     }
-    ic_ptr->outbuflen = length;
+#ifdef FRAME_CRC
+    // the CRC is computed in the copy loop and goes out as one more byte
+    ic_ptr->outbuffer[ic_ptr->outbuflen++] = crc;
+#endif
+#ifdef SMBUS_BLOCK
+    // an SMBus block read reply starts with the number of bytes that follow
+    ic_ptr->outbuffer[0] = ic_ptr->outbuflen - 1;
+#endif
     ic_ptr->outbufind = 1; // point to the second byte to be sent
+    warm_first_reply();
 
     // put the first byte into the I2C peripheral
     SSPBUF = ic_ptr->outbuffer[0];
@@ -105,6 +191,46 @@ void start_i2c_slave_reply(unsigned char length, unsigned char *msg) {
 
 }
 
+#ifdef SMBUS_BLOCK
+// An SMBus block write is the command, a byte count and then the data.
+// The count is checked and dropped here so that the command handlers see
+// the same layout as a plain write.
+
+static void i2c_block_write_unpack() {
+    unsigned char i;
+
+    if (ic_ptr->msglen < 2) {
+        // just a command (e.g. the first half of a block read)
+        return;
+    }
+    if (ic_ptr->buffer[1] != ic_ptr->msglen - 2) {
+        i2c_slave_error(I2C_ERR_MSG_TRUNC);
+        // make sure no command acts on it -- a read that follows gets an
+        // empty block
+        ic_ptr->buffer[0] = I2C_CMD_NONE;
+        ic_ptr->msglen = 1;
+        return;
+    }
+    // (the event count after the data moves down with it)
+    for (i = 1; i < ic_ptr->msglen; i++) {
+        ic_ptr->buffer[i] = ic_ptr->buffer[i + 1];
+    }
+    ic_ptr->msglen--;
+}
+#endif
+
+#ifdef I2C_REGMAP
+// send the byte at the register pointer and move the pointer on
+
+static void i2c_regmap_send() {
+    SSPBUF = regmap[ic_ptr->regptr];
+    ic_ptr->regptr++;
+    if (ic_ptr->regptr >= REGMAP_LEN) {
+        ic_ptr->regptr = REG_SEQ;
+    }
+}
+#endif
+
 // an internal subroutine used in the slave version of the i2c_int_handler
 
 void handle_start(unsigned char data_read) {
@@ -116,8 +242,7 @@ void handle_start(unsigned char data_read) {
             // this is bad because we got data and
             // we wanted an address
             ic_ptr->status = I2C_IDLE;
-            ic_ptr->error_count++;
-            ic_ptr->error_code = I2C_ERR_NOADDR;
+            i2c_slave_error(I2C_ERR_NOADDR);
         } else {
             if (SSPSTATbits.R_W == 1) {
                 ic_ptr->status = I2C_SLAVE_SEND;
@@ -137,6 +262,7 @@ void handle_start(unsigned char data_read) {
 //    master code should be in a subroutine called "i2c_master_handler()"
 
 void i2c_int_handler(){
+    gov_activity();
 #ifdef I2CMASTER
     i2c_master_int_handler();
 #else
@@ -178,6 +304,7 @@ void i2c_master_int_handler() {
                     }
                 } else {
                     // keep trying if we get a NACK
+                    busmon_retry();
                     SSPCON2bits.RSEN = 1;
                     ic_ptr->status = I2C_WRITE_ADDR;
                 }
@@ -192,10 +319,11 @@ void i2c_master_int_handler() {
                     // if we get a NACK send a msg
                     if(ic_ptr->buffer[4] == 0x78)
                         LATBbits.LATB2 = 1;
-                    ToMainHigh_sendmsg(0, MSGT_I2C_MASTER_RECV_FAILED, ic_ptr->buffer);
+                    i2c_master_tomain(0, MSGT_I2C_MASTER_RECV_FAILED, ic_ptr->buffer);
                     LATBbits.LATB2 = 0;
                     ic_ptr->buflen = 0; // we don't want any data if it fails
                     ic_ptr->status = I2C_IDLE;
+                    busmon_end(1, ic_ptr->outbuflen);
                 }
                 break;
             }
@@ -207,13 +335,20 @@ void i2c_master_int_handler() {
                     ic_ptr->buffer[ic_ptr->bufind] = SSPBUF;
                     ic_ptr->bufind++;
                     ic_ptr->status = I2C_RCV_DATA;
-                    
+#ifdef SMBUS_BLOCK
+                    // a block read is a count and then that many bytes, so
+                    // the count says where it ends (the length asked for is
+                    // the most that will be read)
+                    if ((ic_ptr->bufind == 1) && (ic_ptr->buffer[0] < ic_ptr->buflen)) {
+                        ic_ptr->buflen = ic_ptr->buffer[0] + 1;
+                    }
+#endif
                 }
                 if(ic_ptr->bufind == ic_ptr->buflen){ // no more data
                     ic_ptr->status = I2C_END_WRITE;
 
                     // send the buffer to main
-                    ToMainHigh_sendmsg(ic_ptr->buflen, MSGT_I2C_MASTER_RECV_COMPLETE, ic_ptr->buffer);
+                    i2c_master_tomain(ic_ptr->buflen, MSGT_I2C_MASTER_RECV_COMPLETE, ic_ptr->buffer);
 
                     // NACK
                     SSPCON2bits.ACKDT = 1;
@@ -238,6 +373,7 @@ void i2c_master_int_handler() {
                 SSPCON2bits.PEN = 1; // say stop
                 
                 ic_ptr->status = I2C_IDLE;
+                busmon_end(0, ic_ptr->outbuflen + ic_ptr->bufind);
                 break;
             }
         }
@@ -245,6 +381,244 @@ void i2c_master_int_handler() {
 
 }
 
+// A bus collision (another master won the arbitration, or the bus was busy
+// when the start was sent) leaves the MSSP idle, and no SSPIF follows it.
+// The transfer is given up here and main() is told it failed, as for a
+// NACK, so that whatever was waiting on it (dready_done()) can try again.
+void i2c_bus_collision_handler() {
+    if (ic_ptr->status != I2C_IDLE) {
+        ic_ptr->status = I2C_IDLE;
+        ic_ptr->buflen = 0;
+        busmon_end(1, ic_ptr->outbuflen);
+        i2c_master_tomain(0, MSGT_I2C_MASTER_RECV_FAILED, ic_ptr->buffer);
+    }
+}
+
+// everything that happens once a write to the slave is complete
+
+static void i2c_slave_msg_done() {
+#ifdef SMBUS_BLOCK
+    i2c_block_write_unpack();
+#endif
+#ifdef I2C_REGMAP
+    if ((ic_ptr->msglen > 1) && (ic_ptr->buffer[0] == REGMAP_CMD)
+            && (ic_ptr->buffer[1] < REGMAP_LEN)) {
+        ic_ptr->regptr = ic_ptr->buffer[1];
+    }
+#endif
+    // the message is the data with the event count after it
+    i2c_slave_tomain(ic_ptr->msglen + 1, MSGT_I2C_DATA, (void *) ic_ptr->buffer);
+}
+
+// tell main about errors once there are enough of them
+
+static void i2c_slave_errors() {
+    unsigned char error_buf[3];
+
+    if (ic_ptr->error_count >= I2C_ERR_THRESHOLD) {
+        error_buf[0] = ic_ptr->error_count;
+        error_buf[1] = ic_ptr->error_code;
+        error_buf[2] = ic_ptr->event_count;
+        i2c_slave_tomain(sizeof (unsigned char) *3, MSGT_I2C_DBG, (void *) error_buf);
+        ic_ptr->error_count = 0;
+    }
+}
+
+// build the reply to a slave read from the command last written, and
+// start sending it
+
+static void i2c_slave_reply() {
+    int length = 0;
+
+#ifdef I2C_VIRTUAL
+#ifndef I2C_SLAVE_STATS
+    if (ic_ptr->device == I2C_DEV_DIAG) {
+        // there is nothing to report, but the read must still be answered
+        // or the master waits on the held clock
+        ic_ptr->buffer[0] = 0x00;
+        start_i2c_slave_reply(1, ic_ptr->buffer);
+        return;
+    }
+#endif
+    if (ic_ptr->device != I2C_DEV_CMD) {
+        // a read from a virtual device stands for its one command
+        ic_ptr->buffer[0] = i2c_dev_cmds[ic_ptr->device];
+        ic_ptr->buffer[1] = 0x00;
+        ic_ptr->msglen = 1;
+    }
+#endif
+    
+    // send to the queue to *ask* for the data to be sent out
+    //ToMainHigh_sendmsg(0, MSGT_I2C_RQST, (void *) ic_ptr->buffer);
+    if(ic_ptr->buffer[0] == 0xAA){ //Gather Request
+        length = 3;
+        unsigned char gatherAck[3] = {0x00, 0x01, 0x01};
+        start_i2c_slave_reply(length, gatherAck);
+        unsigned char reply[5] = {0xAA, 0x00, 0x00, 0x00, 0x00};
+        i2c_slave_tomain(5, MSGT_SLAVE_RCV, reply);
+    } else if(ic_ptr->buffer[0] == 0xAB){ //Gather Check
+        unsigned char msgtype = 0;
+        unsigned char sensorBuf;
+        unsigned char noData[5] = {0x00,0x00,0x00,0x00,0x00};
+        // reply straight out of the frame's pool buffer
+        length = route_recvbuf(ROUTE_SENSOR_DATA, &msgtype, &sensorBuf);
+#ifndef I2C_REGMAP
+        // (with the register map, main() ends it when the map is updated)
+        if (length > 0)
+            latency_end(LAT_GATHER);
+#endif
+        if (route_depth(ROUTE_SENSOR_DATA) == 0)
+            dready_clear();
+        noData[1] = length;
+        noData[2] = msgtype;
+        if(length == 5 && msgtype == MSGT_UART_DATA) {
+#ifdef FRAME_DELTA
+           // the byte after the command acks the last frame decoded
+           unsigned char coded[FD_BUFLEN];
+           length = frame_delta_encode(msg_buf(sensorBuf),
+                   (ic_ptr->msglen > 1) ? ic_ptr->buffer[1] : FD_NOSEQ, coded);
+           start_i2c_slave_reply(length, coded);
+#else
+           start_i2c_slave_reply(length, msg_buf(sensorBuf));
+#endif
+        } else {
+#ifdef SMBUS_BLOCK
+           // nothing new, so the master only has to read the count
+           start_i2c_slave_reply(0, noData);
+#else
+           start_i2c_slave_reply(5, noData);
+#endif
+        }
+        if (length >= 0)
+            msg_free(sensorBuf);
+#ifdef SENSOR_FUSION
+    } else if(ic_ptr->buffer[0] == 0xAC){ //Fused Sensors
+        unsigned char fused[FUSION_REPORTLEN];
+        length = fusion_report(fused);
+        // nothing new since the sequence number the master sent
+        if ((ic_ptr->msglen > 1) && (ic_ptr->buffer[1] == fused[0]))
+            length = 1;
+        start_i2c_slave_reply(length, fused);
+#endif
+    } else if(ic_ptr->buffer[0] == 0xBA){ //Movement Command
+       length = 3;
+       unsigned char movecomAck[3] = {MOTOR_ACK_OK, 0x00, 0x00};
+       unsigned char seq = 0;
+       // the sequence number is optional
+       if (ic_ptr->msglen > MOTOR_CMDLEN)
+           seq = ic_ptr->buffer[MOTOR_CMDLEN];
+       if (motor_cmd_post(seq, ic_ptr->buffer) != MSGSEND_OKAY)
+           movecomAck[0] = MOTOR_ACK_FULL;
+       movecomAck[1] = motor_cmd_applied();
+       movecomAck[2] = motor_cmd_depth();
+       start_i2c_slave_reply(length, movecomAck);
+    } else if(ic_ptr->buffer[0] == 0xBB) {
+        unsigned char msgtype = 0;
+        unsigned char motorBuf;
+        unsigned char *motorData;
+        unsigned char noData[5] = {0x00,0x00,0x00};
+#ifdef QUAD_ENCODERS
+        unsigned char status[5 + ENC_REPORTLEN];
+        unsigned char i;
+#endif
+        length = route_recvbuf(ROUTE_SENSOR_DATA, &msgtype, &motorBuf);
+#ifndef I2C_REGMAP
+        // (with the register map, main() ends it when the map is updated)
+        if (length > 0)
+            latency_end(LAT_GATHER);
+#endif
+        if (route_depth(ROUTE_SENSOR_DATA) == 0)
+            dready_clear();
+        noData[1] = length;
+        noData[2] = msgtype;
+        if((length == 5) && (msgtype == MSGT_UART_DATA)) {
+            motorData = msg_buf(motorBuf);
+        } else {
+            motorData = noData;
+        }
+        // the last two bytes say which movement command this answers
+        motorData[3] = motor_cmd_applied();
+        motorData[4] = motor_cmd_depth();
+#ifdef QUAD_ENCODERS
+        // and the encoder positions and speeds follow
+        for (i = 0; i < 5; i++)
+            status[i] = motorData[i];
+        start_i2c_slave_reply(5 + enc_report(&status[5]), status);
+#else
+        start_i2c_slave_reply(5, motorData);
+#endif
+        if (length >= 0)
+            msg_free(motorBuf);
+#ifdef ODOMETRY
+    } else if(ic_ptr->buffer[0] == 0xBC) { //Pose
+        unsigned char pose[ODOM_REPORTLEN];
+        length = odom_report((ic_ptr->msglen > 1) ? ic_ptr->buffer[1] : ODOM_POSE, pose);
+        start_i2c_slave_reply(length, pose);
+#endif
+#ifdef LATENCY_STATS
+    } else if(ic_ptr->buffer[0] == 0xCA) { //Latency Stats
+        unsigned char stats[LAT_REPORTLEN];
+        // (a bare 0xCA asks for page 0)
+        length = latency_report((ic_ptr->msglen > 1) ? ic_ptr->buffer[1] : 0, stats);
+        if (length == 0) {
+            stats[0] = 0x00;
+            length = 1;
+        }
+        start_i2c_slave_reply(length, stats);
+        if ((ic_ptr->msglen > 2) && ic_ptr->buffer[2])
+            latency_clear(ic_ptr->buffer[1]);
+#endif
+#ifdef I2C_SLAVE_STATS
+    } else if(ic_ptr->buffer[0] == 0xCB) { //Slave Stats
+        unsigned char stats[I2C_STATS_REPORTLEN];
+        // (a bare 0xCB asks for page 0)
+        length = i2c_slave_stats_report((ic_ptr->msglen > 1) ? ic_ptr->buffer[1] : 0, stats);
+        start_i2c_slave_reply(length, stats);
+        if ((ic_ptr->msglen > 2) && ic_ptr->buffer[2])
+            i2c_slave_stats_clear();
+#endif
+#ifdef CLOCK_GOVERNOR
+    } else if(ic_ptr->buffer[0] == 0xCD) { //Clock Governor
+        unsigned char stats[GOV_REPORTLEN];
+        length = gov_report(stats);
+        start_i2c_slave_reply(length, stats);
+        if ((ic_ptr->msglen > 1) && ic_ptr->buffer[1])
+            gov_clear();
+#endif
+#ifdef MOTOR_PID
+    } else if(ic_ptr->buffer[0] == 0xCF) { //Motor Loop Stats
+        unsigned char stats[PID_REPORTLEN];
+        length = pid_report(stats);
+        start_i2c_slave_reply(length, stats);
+        if ((ic_ptr->msglen > 1) && ic_ptr->buffer[1])
+            pid_clear();
+#endif
+#ifdef TRAFFIC_CAPTURE
+    } else if(ic_ptr->buffer[0] == 0xCE) { //Capture Dump
+        unsigned char count = capture_dump();
+        start_i2c_slave_reply(1, &count);
+#endif
+#ifdef WARM_RESTART
+    } else if(ic_ptr->buffer[0] == 0xCC) { //Boot Info
+        unsigned char info[WARM_REPORTLEN];
+        length = warm_report(info);
+        start_i2c_slave_reply(length, info);
+#endif
+#ifdef I2C_REGMAP
+    } else if(ic_ptr->buffer[0] == REGMAP_CMD) { //Register Map
+        ic_ptr->status = I2C_SLAVE_REGS;
+        i2c_regmap_send();
+        SSPCON1bits.CKP = 1;
+#endif
+#ifdef SMBUS_BLOCK
+    } else {
+        // a command with no reply (or a block write whose count was wrong):
+        // an empty block, so the master's read still ends
+        start_i2c_slave_reply(0, ic_ptr->buffer);
+#endif
+    }
+}
+
 void i2c_slave_int_handler() {
     unsigned char i2c_data;
     unsigned char data_read = 0;
@@ -252,7 +626,16 @@ void i2c_slave_int_handler() {
     unsigned char msg_ready = 0;
     unsigned char msg_to_send = 0;
     unsigned char overrun_error = 0;
-    unsigned char error_buf[3];
+#ifdef TRAFFIC_CAPTURE
+    unsigned char sspstat = SSPSTAT;
+    unsigned char sspov = SSPCON1bits.SSPOV;
+#endif
+#ifdef I2C_SLAVE_STATS
+    unsigned int start_time = ReadTimer1();
+    unsigned int elapsed;
+
+    i2c_stats.events++;
+#endif
 
     // clear SSPOV
     if (SSPCON1bits.SSPOV == 1) {
@@ -262,14 +645,20 @@ void i2c_slave_int_handler() {
         // a state where we are looking for a new message
         ic_ptr->status = I2C_IDLE;
         overrun_error = 1;
-        ic_ptr->error_count++;
-        ic_ptr->error_code = I2C_ERR_OVERRUN;
+        i2c_slave_error(I2C_ERR_OVERRUN);
     }
     // read something if it is there
     if (SSPSTATbits.BF == 1) {
         i2c_data = SSPBUF;
         data_read = 1;
+#ifdef I2C_VIRTUAL
+        // the address bits that SSPMSK ignores say which device this is for
+        if (SSPSTATbits.D_A == 0) {
+            ic_ptr->device = I2C_DEV(i2c_data);
+        }
+#endif
     }
+    capture_i2c(sspstat, sspov, data_read ? i2c_data : 0);
 
     if (!overrun_error) {
         switch (ic_ptr->status) {
@@ -297,8 +686,7 @@ void i2c_slave_int_handler() {
                         if (SSPSTATbits.D_A == 0) {
                             msg_ready = 1;
                         } else {
-                            ic_ptr->error_count++;
-                            ic_ptr->error_code = I2C_ERR_NODATA;
+                            i2c_slave_error(I2C_ERR_NODATA);
                         }
                     }
                     ic_ptr->status = I2C_IDLE;
@@ -314,25 +702,44 @@ void i2c_slave_int_handler() {
                             data_read = 0;
                         }
                     } else {
-                        ic_ptr->error_count++;
                         ic_ptr->status = I2C_IDLE;
-                        ic_ptr->error_code = I2C_ERR_NODATA;
+                        i2c_slave_error(I2C_ERR_NODATA);
                     }
                 }
                 break;
             }
             case I2C_SLAVE_SEND:
             {
-                if (ic_ptr->outbufind < ic_ptr->outbuflen) {
+                if ((SSPSTATbits.R_W == 0) || (SSPSTATbits.P == 1)) {
+                    // the master NACKed the last byte (or stopped), which
+                    // ends the read (a byte loaded now would sit in SSPBUF
+                    // and NACK the next address)
+                    ic_ptr->status = I2C_IDLE;
+                } else if (ic_ptr->outbufind < ic_ptr->outbuflen) {
                     SSPBUF = ic_ptr->outbuffer[ic_ptr->outbufind];
                     ic_ptr->outbufind++;
                     data_written = 1;
                 } else {
-                    // we have nothing left to send
+                    // the master reads past the reply: pad it rather than
+                    // hold the clock for good
+                    SSPBUF = 0xFF;
+                    data_written = 1;
+                }
+                break;
+            }
+#ifdef I2C_REGMAP
+            case I2C_SLAVE_REGS:
+            {
+                // keep streaming until the master NACKs, which clears R_W
+                if (SSPSTATbits.R_W == 1) {
+                    i2c_regmap_send();
+                    data_written = 1;
+                } else {
                     ic_ptr->status = I2C_IDLE;
                 }
                 break;
             }
+#endif
             case I2C_RCV_DATA:
             {
                 // we expect either data or a stop bit or a (if a restart, an addr)
@@ -345,8 +752,7 @@ void i2c_slave_int_handler() {
                             ic_ptr->buflen++;
                             msg_ready = 1;
                         } else {
-                            ic_ptr->error_count++;
-                            ic_ptr->error_code = I2C_ERR_NODATA;
+                            i2c_slave_error(I2C_ERR_NODATA);
                             ic_ptr->status = I2C_IDLE;
                         }
                     } else {
@@ -365,10 +771,12 @@ void i2c_slave_int_handler() {
                             msg_to_send = 1;
                             // don't let the clock stretching bit be let go
                             data_read = 0;
-                        } else { /* bad to recv an address again, we aren't ready */
-                            ic_ptr->error_count++;
-                            ic_ptr->error_code = I2C_ERR_NODATA;
-                            ic_ptr->status = I2C_IDLE;
+                        } else {
+                            // a write after a repeated start, or after a
+                            // stop that came too close to the start for
+                            // this interrupt to see P: the message so far
+                            // is done, and this is the start of the next
+                            msg_ready = 1;
                         }
                     }
                 }
@@ -378,6 +786,14 @@ void i2c_slave_int_handler() {
     }
 
     // release the clock stretching bit (if we should)
+#ifdef I2C_DEFERRED
+    if (data_read && (ic_ptr->msg_pending || msg_ready)) {
+        // the last message is still in the buffer (or is about to be, for
+        // a write that follows it at once), so hold the bus until
+        // i2c_slave_work() is done with it
+        ic_ptr->hold = 1;
+    } else
+#endif
     if (data_read || data_written) {
         // release the clock
         if (SSPCON1bits.CKP == 0) {
@@ -388,74 +804,139 @@ void i2c_slave_int_handler() {
     // must check if the message is too long, if
     if ((ic_ptr->buflen > MAXI2CBUF - 2) && (!msg_ready)) {
         ic_ptr->status = I2C_IDLE;
-        ic_ptr->error_count++;
-        ic_ptr->error_code = I2C_ERR_MSGTOOLONG;
+        i2c_slave_error(I2C_ERR_MSGTOOLONG);
     }
 
     if (msg_ready) {
+#ifdef I2C_SLAVE_STATS
+        i2c_stats.transactions++;
+#endif
+        // remember how much was written for the reply that may follow
+        ic_ptr->msglen = ic_ptr->buflen;
         ic_ptr->buffer[ic_ptr->buflen] = ic_ptr->event_count;
-        ToMainHigh_sendmsg(ic_ptr->buflen + 1, MSGT_I2C_DATA, (void *) ic_ptr->buffer);
         ic_ptr->buflen = 0;
-    } else if (ic_ptr->error_count >= I2C_ERR_THRESHOLD) {
-        error_buf[0] = ic_ptr->error_count;
-        error_buf[1] = ic_ptr->error_code;
-        error_buf[2] = ic_ptr->event_count;
-        ToMainHigh_sendmsg(sizeof (unsigned char) *3, MSGT_I2C_DBG, (void *) error_buf);
-        ic_ptr->error_count = 0;
+#ifdef I2C_DEFERRED
+        ic_ptr->msg_pending = 1;
+#else
+        i2c_slave_msg_done();
+    } else {
+        i2c_slave_errors();
+#endif
     }
     if (msg_to_send) {
-        int length = 0;
-        
-        // send to the queue to *ask* for the data to be sent out
-        //ToMainHigh_sendmsg(0, MSGT_I2C_RQST, (void *) ic_ptr->buffer);
-        if(ic_ptr->buffer[0] == 0xAA){ //Gather Request
-            length = 3;
-            unsigned char gatherAck[3] = {0x00, 0x01, 0x01};
-            start_i2c_slave_reply(length, gatherAck);
-            unsigned char reply[5] = {0xAA, 0x00, 0x00, 0x00, 0x00};
-            ToMainHigh_sendmsg(5, MSGT_SLAVE_RCV, reply);
-        } else if(ic_ptr->buffer[0] == 0xAB){ //Gather Check
-            int msgtype;
-            unsigned char sensorData[5];
-            unsigned char noData[5] = {0x00,0x00,0x00,0x00,0x00};
-            length = FromMainLow_recvmsg(MAXUARTBUF, (unsigned char *)&msgtype, sensorData);
-            noData[1] = length;
-            noData[2] = msgtype;
-            if(length == 5 && msgtype == MSGT_UART_DATA) {
-               start_i2c_slave_reply(length, sensorData);
-            } else {
-               start_i2c_slave_reply(5, noData);
-            }
-        } else if(ic_ptr->buffer[0] == 0xBA){ //Movement Command
-           length = 3;
-           unsigned char movecomAck[3] = {0x02, 0x01, 0x01};
-           start_i2c_slave_reply(length, movecomAck);
-           ToMainHigh_sendmsg(5, MSGT_SLAVE_RCV, ic_ptr->buffer);
-        } else if(ic_ptr->buffer[0] == 0xBB) {
-            int msgtype;
-            unsigned char motorData[5];
-            unsigned char noData[5] = {0x00,0x00,0x00};
-            length = FromMainLow_recvmsg(MAXUARTBUF, (unsigned char *)&msgtype, motorData);
-            noData[1] = length;
-            noData[2] = msgtype;
-            if((length == 5) && (msgtype == MSGT_UART_DATA))
-                start_i2c_slave_reply(length-2, motorData);
-            else
-                start_i2c_slave_reply(3, noData);
-        }
+#ifdef I2C_SLAVE_STATS
+        i2c_stats.transactions++;
+#endif
+#ifdef I2C_DEFERRED
+        ic_ptr->reply_pending = 1;
+#else
+        i2c_slave_reply();
+#endif
         msg_to_send = 0;
     }
+#ifdef I2C_DEFERRED
+    // the rest is done by i2c_slave_work(), at low priority
+    if (ic_ptr->msg_pending || ic_ptr->reply_pending
+            || (ic_ptr->error_count >= I2C_ERR_THRESHOLD)) {
+        defer_post(WORK_I2C_SLAVE);
+    }
+#endif
+#ifdef I2C_SLAVE_STATS
+    elapsed = ReadTimer1() - start_time;
+    i2c_stats.ticks += elapsed;
+    if (elapsed > i2c_stats.ticks_max) {
+        i2c_stats.ticks_max = elapsed;
+    }
+#endif
+}
+
+#ifdef I2C_DEFERRED
+// The bottom half of the slave handler, run at low priority (see defer.h).
+// The top half sets each *_pending flag once the bytes are off the bus;
+// the flags are only cleared here, after the work, so that the top half
+// knows to hold the bus for as long as the buffer is in use.
+
+void i2c_slave_work() {
+    if (ic_ptr->msg_pending) {
+        i2c_slave_msg_done();
+        ic_ptr->msg_pending = 0;
+    } else {
+        i2c_slave_errors();
+    }
+    if (ic_ptr->reply_pending) {
+        i2c_slave_reply();
+        ic_ptr->reply_pending = 0;
+    }
+    if (ic_ptr->hold) {
+        ic_ptr->hold = 0;
+        SSPCON1bits.CKP = 1;
+    }
+}
+#endif
+
+#ifdef I2C_SLAVE_STATS
+// Fill in one page of the 0xCB reply -- see my_i2c.h for the layout
+
+unsigned char i2c_slave_stats_report(unsigned char page, unsigned char *buf) {
+    unsigned int words[I2C_STATS_REPORTLEN / 2];
+    unsigned char i;
+
+    if (page == 0) {
+        words[0] = i2c_stats.events;
+        words[1] = i2c_stats.transactions;
+        words[2] = i2c_stats.ticks & 0xFFFF;
+        words[3] = i2c_stats.ticks >> 16;
+        words[4] = i2c_stats.ticks_max;
+    } else if (page == 1) {
+        for (i = 0; i < I2C_STATS_REPORTLEN / 2; i++) {
+            words[i] = i2c_stats.errors[i];
+        }
+    } else {
+        for (i = 0; i < I2C_STATS_REPORTLEN / 2; i++) {
+            words[i] = 0;
+        }
+        words[0] = sleep_wakeups();
+        words[1] = uart_crc_errors();
+        words[2] = msg_pool_empty();
+    }
+    for (i = 0; i < I2C_STATS_REPORTLEN / 2; i++) {
+        buf[2 * i] = words[i] & 0xFF;
+        buf[2 * i + 1] = words[i] >> 8;
+    }
+    return (I2C_STATS_REPORTLEN);
 }
 
+void i2c_slave_stats_clear() {
+    unsigned char i;
+
+    i2c_stats.events = 0;
+    i2c_stats.transactions = 0;
+    i2c_stats.ticks = 0;
+    i2c_stats.ticks_max = 0;
+    for (i = 0; i < I2C_NUM_ERRS; i++) {
+        i2c_stats.errors[i] = 0;
+    }
+}
+#endif
+
 // set up the data structures for this i2c code
 // should be called once before any i2c routines are called
 
 void init_i2c(i2c_comm *ic) {
     ic_ptr = ic;
     ic_ptr->buflen = 0;
+    ic_ptr->msglen = 0;
     ic_ptr->event_count = 0;
     ic_ptr->status = I2C_IDLE;
     ic_ptr->error_count = 0;
+    ic_ptr->device = I2C_DEV_CMD;
+    ic_ptr->regptr = REG_SEQ;
+    ic_ptr->msg_pending = 0;
+    ic_ptr->reply_pending = 0;
+    ic_ptr->hold = 0;
+#ifdef I2C_SLAVE_STATS
+    i2c_slave_stats_clear();
+#endif
 }
 
 // setup the PIC to operate as a slave
@@ -478,6 +959,17 @@ void i2c_configure_slave(unsigned char addr) {
 #endif
 #endif
 
+#ifdef I2C_VIRTUAL
+#if defined(__USE18F26J50) || defined(__USE18F46J50)
+    // with MSSP7B_EN = MSK7, a write to SSPADD while SSPM is 1001 lands in
+    // SSPMSK instead; its clear bits are the ones the address match ignores
+    SSPCON1 = 0x09;
+    SSPADD = I2C_DEV_ADDRMASK;
+    SSPCON1 = 0x0;
+#else
+#error "I2C_VIRTUAL needs the address masking of the J50 parts"
+#endif
+#endif
     // set the address
     SSPADD = addr;
     //OpenI2C(SLAVE_7,SLEW_OFF); // replaced w/ code below
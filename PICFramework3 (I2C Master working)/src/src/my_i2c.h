@@ -2,20 +2,40 @@
 #define __my_i2c_h
 
 #include "messages.h"
+#include "encoder.h"
 
 #define MAXI2CBUF MSGLEN
+// the longest reply, which is 0xBB once it carries the encoders
+#ifdef QUAD_ENCODERS
+#define I2C_MAXREPLY (5 + ENC_REPORTLEN)
+#else
+#define I2C_MAXREPLY MAXI2CBUF
+#endif
+// master mode baud rate generator: Fosc / (4 * (SSPADD + 1)), 400 kHz
+// at 48 MHz
+#define I2C_MASTER_SSPADD 29
 typedef struct __i2c_comm {
     unsigned char buffer[MAXI2CBUF];
     unsigned char buflen;
+    unsigned char msglen;
     unsigned char bufind;
     unsigned char event_count;
     unsigned char status;
     unsigned char error_code;
     unsigned char error_count;
-    unsigned char outbuffer[MAXI2CBUF];
+    // room for a reply plus its SMBus byte count and its CRC
+    unsigned char outbuffer[I2C_MAXREPLY + 2];
     unsigned char outbuflen;
     unsigned char outbufind;
     unsigned char slave_addr;
+    // which virtual device the last address byte matched (I2C_VIRTUAL)
+    unsigned char device;
+    // next register a read streams out of the register map (I2C_REGMAP)
+    unsigned char regptr;
+    // work left for i2c_slave_work() (I2C_DEFERRED)
+    unsigned char msg_pending;
+    unsigned char reply_pending;
+    unsigned char hold;
 } i2c_comm;
 
 #define I2C_IDLE 0x5
@@ -27,6 +47,10 @@ typedef struct __i2c_comm {
 #define I2C_END_WRITE 0xB
 #define I2C_ACK 0xC
 #define I2C_REP_START 0xD
+#define I2C_SLAVE_REGS 0xE
+
+// not a command, for a write that no command should act on
+#define I2C_CMD_NONE 0xFF
 
 #define I2C_ERR_THRESHOLD 1
 #define I2C_ERR_OVERRUN 0x4
@@ -34,15 +58,61 @@ typedef struct __i2c_comm {
 #define I2C_ERR_NODATA 0x6
 #define I2C_ERR_MSGTOOLONG 0x7
 #define I2C_ERR_MSG_TRUNC 0x8
+#define I2C_NUM_ERRS 5
+
+// Virtual slave devices (enabled with I2C_VIRTUAL in maindefs.h)
+// SSPMSK makes the MSSP ignore address bits 3 and 1, so the slave answers
+// to four addresses and those two bits pick the device.  The address given
+// to i2c_configure_slave() is the command device and works as before; a
+// read from any of the others returns what its one command would, with no
+// command byte and no write first.  Bit 2 is still matched, so the sensor
+// PIC (0x9E) answers to 0x94, 0x96, 0x9C and 0x9E and stays clear of the
+// temperature sensor at 0x9A.
+#define I2C_DEV_ADDRMASK 0xF5
+#define I2C_DEV(addr) ((((addr) >> 1) & 0x01) | (((addr) >> 2) & 0x02))
+#define I2C_DEV_SENSOR 0   // same reply as 0xAB (0x94 on the sensor PIC)
+#define I2C_DEV_MOTOR 1    // same reply as 0xBB (0x96)
+#define I2C_DEV_DIAG 2     // same reply as 0xCB page 0 (0x9C), or a single
+                           // 0x00 without I2C_SLAVE_STATS
+#define I2C_DEV_CMD 3      // command byte first (0x9E)
+#define I2C_NUM_DEVS 4
+
+// Slave state machine statistics (enabled with I2C_SLAVE_STATS in maindefs.h)
+// A 0xCB write of [0xCB, page, clear] followed by a read returns five
+// little-endian words:
+//   page 0: events, transactions, handler time (low word, high word), and
+//           the longest single event, all times in timer1 counts
+//   page 1: how often each error fired, I2C_ERR_OVERRUN .. I2C_ERR_MSG_TRUNC
+//   page 2: times main() has woken from sleep (see sleep_wakeups()), UART
+//           frames dropped for a bad CRC (FRAME_CRC), sends that found the
+//           message pool empty (see msg_pool_empty()), then zeros; read it
+//           twice a known time apart for the rates
+// Cycles per event = handler time / events (times 8 on the J50 builds).
+#define I2C_STATS_REPORTLEN 10
+typedef struct __i2c_slave_stats {
+    unsigned int events;
+    unsigned int transactions;
+    unsigned long ticks;
+    unsigned int ticks_max;
+    unsigned int errors[I2C_NUM_ERRS];
+} i2c_slave_stats;
 
 void init_i2c(i2c_comm *);
 void i2c_int_handler(void);
 void i2c_master_int_handler(void);
+void i2c_bus_collision_handler(void);
 void i2c_slave_int_handler(void);
 void start_i2c_slave_reply(unsigned char,unsigned char *);
 void i2c_configure_slave(unsigned char);
 void i2c_configure_master();
 unsigned char i2c_master_send(unsigned char, unsigned char, unsigned char *, unsigned char);
 unsigned char i2c_master_recv(unsigned char);
+#ifdef I2C_DEFERRED
+void i2c_slave_work(void);
+#endif
+#ifdef I2C_SLAVE_STATS
+unsigned char i2c_slave_stats_report(unsigned char, unsigned char *);
+void i2c_slave_stats_clear(void);
+#endif
 
 #endif
\ No newline at end of file
@@ -5,10 +5,70 @@
 #include <plib/usart.h>
 #endif
 #include "my_uart.h"
+#include "routes.h"
+#include "motor_cmd.h"
+#include "latency.h"
+#include "crc8.h"
+#include "warm.h"
+#include "governor.h"
+#include "capture.h"
+#include "binlog.h"
+#include "fusion.h"
+#include "pid.h"
+#include "dready.h"
+#include "busmon.h"
 
 static uart_comm *uc_ptr;
+unsigned int uartTimeOut;
+
+// a frame is received into a pool buffer, so it can be passed on without
+// a copy
+
+static void uart_new_frame() {
+    if (uc_ptr->rxbuf == MSG_NOBUF) {
+        uc_ptr->rxbuf = msg_alloc();
+    }
+    if (uc_ptr->rxbuf == MSG_NOBUF) {
+        // the pool is empty, so the frame is only taken in to stay in step
+        uc_ptr->buffer = uc_ptr->scratch;
+    } else {
+        uc_ptr->buffer = msg_buf(uc_ptr->rxbuf);
+    }
+}
+
+// complete frames go straight to the I2C handler that replies with them
+
+static void uart_send_frame() {
+    signed char retval = MSGPOOL_EMPTY;
+
+    fusion_update(uc_ptr->buffer);
+    warm_save_frame(uc_ptr->buffer);
+    latency_start(LAT_GATHER);
+    if (uc_ptr->rxbuf != MSG_NOBUF) {
+#ifdef I2C_REGMAP
+        // main copies the frame into the register map and passes it on
+        retval = ToMainLow_sendbuf(MAXUARTBUF, MSGT_UART_DATA, uc_ptr->rxbuf);
+#else
+        retval = route_sendbuf(ROUTE_SENSOR_DATA, MAXUARTBUF, MSGT_UART_DATA, uc_ptr->rxbuf);
+#endif
+    }
+    if (retval == MSGSEND_OKAY) {
+        // the buffer belongs to the queue now
+        uc_ptr->rxbuf = MSG_NOBUF;
+#ifndef I2C_REGMAP
+        // (with the register map, main() does this once the map is updated)
+        dready_set();
+#endif
+    } else {
+        // (if the queue was full, the buffer is kept for the next frame)
+        latency_drop(LAT_GATHER);
+    }
+}
 
 void uart_recv_int_handler() {
+    if (uc_ptr->buflen == 0) {
+        uart_new_frame();
+    }
 #ifdef __USE18F26J50
     if (DataRdy1USART()) {
         uc_ptr->buffer[uc_ptr->buflen] = Read1USART();
@@ -22,16 +82,41 @@ void uart_recv_int_handler() {
 #endif
 #endif
 
+        gov_activity();
+        capture_uart(uc_ptr->buffer[uc_ptr->buflen]);
+        // after a gap this byte starts a new frame, whatever came before it
+        if(uartTimeOut > UART_TIMEOUT) {
+            uc_ptr->buffer[0] = uc_ptr->buffer[uc_ptr->buflen];
+            uc_ptr->buflen = 0;
+        }
+        uartTimeOut = 0;
         uc_ptr->buflen++;
-        if(uartTimeOut > 200) {
-            uc_ptr->buflen = 1;
-            uartTimeOut = 0;
+#ifdef FRAME_CRC
+        // Each data byte is folded into the CRC as it arrives and the byte
+        // after the data is the sender's CRC, so the check at the end of
+        // the frame is a single compare
+        if (uc_ptr->buflen == 1) {
+            uc_ptr->crc = CRC8_INIT;
+        }
+        if (uc_ptr->buflen <= MAXUARTBUF) {
+            uc_ptr->crc = crc8_update(uc_ptr->crc, uc_ptr->buffer[uc_ptr->buflen - 1]);
+        } else {
+            if (uc_ptr->buffer[MAXUARTBUF] == uc_ptr->crc) {
+                uart_send_frame();
+            } else {
+                // drop the frame
+                uc_ptr->crc_errors++;
+                log_event(LOG_UART_CRC, uc_ptr->buffer[MAXUARTBUF], uc_ptr->crc);
+            }
+            uc_ptr->buflen = 0;
         }
+#else
         // check if a message should be sent
         if (uc_ptr->buflen == MAXUARTBUF) {
-            ToMainLow_sendmsg(uc_ptr->buflen, MSGT_UART_DATA, (void *) uc_ptr->buffer);
+            uart_send_frame();
             uc_ptr->buflen = 0;
         }
+#endif
     }
 #ifdef __USE18F26J50
     if (USART1_Status.OVERRUN_ERROR == 1) {
@@ -46,6 +131,7 @@ void uart_recv_int_handler() {
         // send an error message for this
         RCSTAbits.CREN = 0;
         RCSTAbits.CREN = 1;
+        log_event(LOG_UART_OVERRUN, 0, 0);
         ToMainLow_sendmsg(0, MSGT_OVERRUN, (void *) 0);
     }
 }
@@ -54,29 +140,74 @@ void init_uart_recv(uart_comm *uc) {
     //INTCONbits.GIE = 1;
     //INTCONbits.PEIE = 1;
     uc_ptr = uc;
+    uc_ptr->rxbuf = MSG_NOBUF;
+    uc_ptr->buffer = uc_ptr->scratch;
     uc_ptr->buflen = 0;
+    uc_ptr->crc_errors = 0;
+    // (main()'s uart_comm is not cleared, and the first transmit interrupt
+    // would send whatever was in it)
+    uc_ptr->txBuflen = 0;
+    uc_ptr->txBufind = 0;
 }
 
-void uart_trans(unsigned char length, unsigned char *data){
-    // load up the buffer with the data
-    for (uc_ptr->txBuflen = 0; uc_ptr->txBuflen < length; uc_ptr->txBuflen++) {
-        
-        uc_ptr->txBuff[uc_ptr->txBuflen] = data[uc_ptr->txBuflen];
-        
+unsigned int uart_crc_errors() {
+    return (uc_ptr->crc_errors);
+}
+
+// main() hands its data to the transmit handler on the FromMainLow queue,
+// so it is sent between the other things that go out of the UART and
+// never over the top of one of them
+
+signed char uart_trans(unsigned char length, unsigned char *data){
+    signed char retval;
+
+    if (length > MAXUARTBUF) {
+        length = MAXUARTBUF;
     }
-    uc_ptr->txBufind = 0;
-    PIE1bits.TX1IE = 1;
+    retval = FromMainLow_sendmsg(length, MSGT_UART_SEND, (void *) data);
+    if (retval == MSGSEND_OKAY) {
+        // get the transmit interrupt going if it isn't already
+        PIE1bits.TX1IE = 1;
+    }
+    return (retval);
 }
 
 
 void uart_trans_int_handler(){
+    signed char length;
+    unsigned char msgtype;
 
     if(TXSTAbits.TRMT){
         if(uc_ptr->txBufind < uc_ptr->txBuflen){
            TXREG = uc_ptr->txBuff[uc_ptr->txBufind];
             //TXREG = uc_ptr->txBufind;
            uc_ptr->txBufind++;
-        } else
-            PIE1bits.TX1IE = 0; // reset because we are done
+        } else {
+            // reset because we are done -- this must come before checking
+            // for another movement command, because the I2C handler sets
+            // it again whenever it queues one
+            PIE1bits.TX1IE = 0;
+            length = motor_cmd_next(uc_ptr->txBuff);
+            if (length <= 0) {
+                length = pid_next(uc_ptr->txBuff);
+            }
+            if (length <= 0) {
+                length = busmon_next(uc_ptr->txBuff);
+            }
+            if (length <= 0) {
+                length = FromMainLow_recvmsg(MAXUARTBUF, &msgtype, (void *) uc_ptr->txBuff);
+            }
+            if (length <= 0) {
+                length = capture_next(uc_ptr->txBuff);
+            }
+            if (length <= 0) {
+                length = log_next(uc_ptr->txBuff);
+            }
+            if (length > 0) {
+                uc_ptr->txBuflen = length;
+                uc_ptr->txBufind = 0;
+                PIE1bits.TX1IE = 1;
+            }
+        }
     }
 }
\ No newline at end of file
@@ -7,9 +7,25 @@
 #if (MAXUARTBUF > MSGLEN)
 #define MAXUARTBUF MSGLEN
 #endif
+#if defined(FRAME_CRC) && (MAXUARTBUF + 1 > MSGLEN)
+#error "a UART frame and its CRC must fit in a message buffer"
+#endif
+
+// Number of timer0 ticks without a byte after which the next byte received
+// starts a new frame
+#define UART_TIMEOUT 200
+
 typedef struct __uart_comm {
-    unsigned char buffer[MAXUARTBUF];
+    // The frame being received goes straight into a buffer from the message
+    // pool (rxbuf), which is passed on as it is once the frame is complete.
+    // If the pool is empty it goes into scratch instead and is dropped.
+    unsigned char rxbuf;
+    unsigned char *buffer;
+    // one more than a frame, for its CRC when FRAME_CRC is defined
+    unsigned char scratch[MAXUARTBUF + 1];
     unsigned char buflen;
+    unsigned char crc;
+    unsigned int crc_errors;
     unsigned char txBuff[MAXUARTBUF];
     unsigned char txBuflen;
     unsigned char txBufind;
@@ -17,8 +33,13 @@ typedef struct __uart_comm {
 
 void init_uart_recv(uart_comm *);
 void uart_recv_int_handler(void);
+// Number of frames dropped for a bad CRC with FRAME_CRC (wraps around)
+unsigned int uart_crc_errors(void);
 
-void uart_trans(unsigned char, unsigned char *);
+// Called from main() to send up to MAXUARTBUF bytes (any more are cut
+// off).  Returns MSGSEND_OKAY, or MSGQUEUE_FULL or MSGPOOL_EMPTY if the
+// data was dropped.
+signed char uart_trans(unsigned char, unsigned char *);
 void uart_trans_int_handler();
 
 #endif
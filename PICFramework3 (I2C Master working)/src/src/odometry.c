@@ -0,0 +1,177 @@
+#include "maindefs.h"
+#ifndef __XC8
+#include <timers.h>
+#else
+#include <plib/timers.h>
+#endif
+#include "encoder.h"
+#include "odometry.h"
+
+#if defined(ODOMETRY) && !defined(QUAD_ENCODERS)
+#error "ODOMETRY works from the wheel encoders and needs QUAD_ENCODERS"
+#endif
+
+#ifdef ODOMETRY
+
+// dist * odom_cos() in odom_tick() has to fit in a signed long, rounding
+// and all, and so does the turn of the longest step
+#if (ODOM_MAX_STEP * ODOM_DIST_PER_COUNT) > 131071
+#error "ODOM_UM_PER_COUNT is too large for ODOM_MAX_STEP (see odometry.h)"
+#endif
+#if (2 * ODOM_MAX_STEP * ODOM_TURN_PER_COUNT) > 0x7FFFFFFF
+#error "ODOM_UM_PER_COUNT / ODOM_WHEELBASE_MM is too large for ODOM_MAX_STEP"
+#endif
+
+// sin over a quarter turn in 64 steps, Q14
+static const signed int quarter_sin[65] = {
+    0, 402, 804, 1205, 1606, 2006, 2404, 2801,
+    3196, 3590, 3981, 4370, 4756, 5139, 5520, 5897,
+    6270, 6639, 7005, 7366, 7723, 8076, 8423, 8765,
+    9102, 9434, 9760, 10080, 10394, 10702, 11003, 11297,
+    11585, 11866, 12140, 12406, 12665, 12916, 13160, 13395,
+    13623, 13842, 14053, 14256, 14449, 14635, 14811, 14978,
+    15137, 15286, 15426, 15557, 15679, 15791, 15893, 15986,
+    16069, 16143, 16207, 16261, 16305, 16340, 16364, 16379,
+    16384
+};
+
+// odom_tick() owns the pose (x and y in 1/256 mm, the heading in 1/256
+// binary angle units, of which only the low 24 bits count) and copies it
+// into "pose" with GIEH clear for odom_report().
+static signed long x;
+static signed long y;
+static unsigned long heading;
+static signed long last_pos[NUM_ENCODERS];
+static volatile unsigned char reset_pending;
+static unsigned char pose[ODOM_REPORTLEN];
+
+static unsigned int updates;
+static unsigned int time_last;
+static unsigned int time_max;
+
+void init_odometry() {
+    unsigned char i;
+
+    x = 0;
+    y = 0;
+    heading = 0;
+    for (i = 0; i < NUM_ENCODERS; i++) {
+        last_pos[i] = 0;
+    }
+    for (i = 0; i < ODOM_REPORTLEN; i++) {
+        pose[i] = 0;
+    }
+    reset_pending = 0;
+    updates = 0;
+    time_last = 0;
+    time_max = 0;
+}
+
+signed int odom_sin(unsigned int angle) {
+    unsigned int p = angle & 0x3FFF;
+    unsigned char i;
+    signed int s;
+
+    // fold the angle into the first quarter
+    if (angle & 0x4000) {
+        p = 0x4000 - p;
+    }
+    i = p >> 8;
+    s = quarter_sin[i];
+    if (i < 64) {
+        s += ((signed long) (quarter_sin[i + 1] - s) * (p & 0xFF)) >> 8;
+    }
+    if (angle & 0x8000) {
+        s = -s;
+    }
+    return (s);
+}
+
+// how far an encoder moved since the last tick, within ODOM_MAX_STEP
+
+static signed int odom_step(unsigned char enc) {
+    signed long pos = enc_position(enc);
+    signed long step = pos - last_pos[enc];
+
+    last_pos[enc] = pos;
+    if (step > ODOM_MAX_STEP) {
+        return (ODOM_MAX_STEP);
+    } else if (step < -ODOM_MAX_STEP) {
+        return (-ODOM_MAX_STEP);
+    }
+    return ((signed int) step);
+}
+
+void odom_tick() {
+    unsigned int start = ReadTimer1();
+    signed int left = odom_step(ENC_LEFT);
+    signed int right = odom_step(ENC_RIGHT);
+    signed long turn;
+    signed long dist;
+    unsigned int mid;
+    signed long xmm;
+    signed long ymm;
+    unsigned char gieh;
+
+    if (reset_pending) {
+        x = 0;
+        y = 0;
+        heading = 0;
+        reset_pending = 0;
+    }
+    turn = (signed long) (right - left) * ODOM_TURN_PER_COUNT;
+    dist = ((signed long) (left + right) * ODOM_DIST_PER_COUNT) >> 1;
+    mid = (heading + (turn >> 1)) >> 8;
+    // (rounded, or the truncation adds up to a drift)
+    x += (dist * odom_cos(mid) + 0x2000) >> 14;
+    y += (dist * odom_sin(mid) + 0x2000) >> 14;
+    heading += turn;
+
+    xmm = x >> 8;
+    ymm = y >> 8;
+    gieh = INTCONbits.GIEH;
+    INTCONbits.GIEH = 0;
+    pose[0] = xmm & 0xFF;
+    pose[1] = (xmm >> 8) & 0xFF;
+    pose[2] = (xmm >> 16) & 0xFF;
+    pose[3] = (xmm >> 24) & 0xFF;
+    pose[4] = ymm & 0xFF;
+    pose[5] = (ymm >> 8) & 0xFF;
+    pose[6] = (ymm >> 16) & 0xFF;
+    pose[7] = (ymm >> 24) & 0xFF;
+    pose[8] = (heading >> 8) & 0xFF;
+    pose[9] = (heading >> 16) & 0xFF;
+    INTCONbits.GIEH = gieh;
+
+    updates++;
+    time_last = ReadTimer1() - start;
+    if (time_last > time_max) {
+        time_max = time_last;
+    }
+}
+
+unsigned char odom_report(unsigned char what, unsigned char *buf) {
+    unsigned char gieh = INTCONbits.GIEH;
+    unsigned char i;
+
+    if (what == ODOM_TIMING) {
+        buf[0] = updates & 0xFF;
+        buf[1] = updates >> 8;
+        buf[2] = time_last & 0xFF;
+        buf[3] = time_last >> 8;
+        buf[4] = time_max & 0xFF;
+        buf[5] = time_max >> 8;
+        return (6);
+    }
+    INTCONbits.GIEH = 0;
+    for (i = 0; i < ODOM_REPORTLEN; i++) {
+        buf[i] = pose[i];
+    }
+    INTCONbits.GIEH = gieh;
+    if (what == ODOM_RESET) {
+        reset_pending = 1;
+    }
+    return (ODOM_REPORTLEN);
+}
+
+#endif
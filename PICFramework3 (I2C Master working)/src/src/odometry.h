@@ -0,0 +1,59 @@
+#ifndef __odometry_h
+#define __odometry_h
+
+// Dead-reckoning odometry (enabled with ODOMETRY in maindefs.h; needs
+// QUAD_ENCODERS)
+//
+// On every timer1 overflow, right after the encoder speeds (and before
+// the speed loops), the distance each wheel moved is turned into a new
+// pose: x and y in millimetres from where the pose was last reset, and
+// the heading as a binary angle (65536 to a turn, counterclockwise, 0
+// along x).  The step is taken along the heading halfway through the turn
+// made in the tick.  Everything is fixed point: the distance in 1/256 mm,
+// the heading in 1/256 of a binary angle unit, and sin and cos from a
+// quarter wave table of 65 entries, interpolated, in Q14.
+//
+// Set these for the wheels.  ODOM_UM_PER_COUNT is how far a wheel moves
+// per counted encoder edge, in micrometres.  The longest step (two wheels
+// of ODOM_MAX_STEP counts) in 1/256 mm is multiplied by a Q14 sine in a
+// long, so with ODOM_MAX_STEP at 500 it can be at most 1025 (odometry.c
+// checks this).
+#define ODOM_UM_PER_COUNT 500
+#define ODOM_WHEELBASE_MM 150
+
+// distance per count in 1/256 mm, and heading change per count of
+// difference between the wheels in 1/256 binary angle units
+// (65536 * 256 / 2pi = 2670177)
+#define ODOM_DIST_PER_COUNT ((ODOM_UM_PER_COUNT * 256UL + 500) / 1000)
+#define ODOM_TURN_PER_COUNT ((2670177UL * ODOM_UM_PER_COUNT) / (1000UL * ODOM_WHEELBASE_MM))
+// the most a wheel is taken to have moved in one tick (a guard against
+// overflow, some 5 m/s at 0.5 mm per count)
+#define ODOM_MAX_STEP 500
+
+// The reply to a 0xBC write depends on the byte after the command:
+//   ODOM_POSE (or nothing): x and y (signed little-endian longs, mm) and
+//       the heading (little-endian word)
+//   ODOM_TIMING: three little-endian words: updates, and the last and the
+//       longest time an update took, in timer1 counts (8 Tcy each on the
+//       J50 builds)
+//   ODOM_RESET: the pose, after which it is set back to zero at the
+//       next update
+#define ODOM_POSE 0x00
+#define ODOM_TIMING 0x01
+#define ODOM_RESET 0x80
+#define ODOM_REPORTLEN 10
+
+#ifdef ODOMETRY
+void init_odometry(void);
+// Called from the timer1 interrupt handler
+void odom_tick(void);
+unsigned char odom_report(unsigned char, unsigned char *);
+// sin and cos of a binary angle, in Q14
+signed int odom_sin(unsigned int);
+#define odom_cos(a) odom_sin((a) + 0x4000)
+#else
+#define init_odometry()
+#define odom_tick()
+#endif
+
+#endif
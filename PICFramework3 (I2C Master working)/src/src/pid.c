@@ -0,0 +1,214 @@
+#include "maindefs.h"
+#ifndef __XC8
+#include <timers.h>
+#include <adc.h>
+#else
+#include <plib/timers.h>
+#include <plib/adc.h>
+#endif
+#include "user_interrupts.h"
+#include "pid.h"
+
+#if defined(MOTOR_PID) && !defined(MOTORPIC)
+#error "MOTOR_PID is for the MOTORPIC build"
+#endif
+#if defined(MOTOR_PID) && defined(CLOCK_GOVERNOR)
+#error "CLOCK_GOVERNOR changes the timer1 rate that MOTOR_PID runs at"
+#endif
+
+#ifdef MOTOR_PID
+
+#define LOOP(name, target, feedback, kp, ki, kd) target,
+static const unsigned char targets[NUM_PID_LOOPS] = {
+    PID_LOOPS
+};
+#undef LOOP
+#define LOOP(name, target, feedback, kp, ki, kd) feedback,
+static const unsigned char feedbacks[NUM_PID_LOOPS] = {
+    PID_LOOPS
+};
+#undef LOOP
+#define LOOP(name, target, feedback, kp, ki, kd) kp,
+static const signed int kps[NUM_PID_LOOPS] = {
+    PID_LOOPS
+};
+#undef LOOP
+#define LOOP(name, target, feedback, kp, ki, kd) ki,
+static const signed int kis[NUM_PID_LOOPS] = {
+    PID_LOOPS
+};
+#undef LOOP
+#define LOOP(name, target, feedback, kp, ki, kd) kd,
+static const signed int kds[NUM_PID_LOOPS] = {
+    PID_LOOPS
+};
+#undef LOOP
+
+// The I2C handler leaves each new command in "posted" and sets
+// posted_new last; pid_tick() takes it with GIEH clear.  pid_tick() and
+// pid_next() both run at low priority, so "sent" needs no such care.
+static unsigned char posted[MOTOR_CMDLEN];
+static volatile unsigned char posted_new;
+static unsigned char cmd[MOTOR_CMDLEN];
+static unsigned char sent[MOTOR_CMDLEN];
+static unsigned char sent_ready;
+static unsigned char running;
+static signed int integral[NUM_PID_LOOPS];
+static signed int last_err[NUM_PID_LOOPS];
+
+static unsigned int ticks;
+static unsigned int exec_last;
+static unsigned int exec_max;
+static unsigned int late_min;
+static unsigned int late_max;
+
+void init_pid() {
+    unsigned char i;
+
+    posted_new = 0;
+    sent_ready = 0;
+    running = 0;
+    for (i = 0; i < NUM_PID_LOOPS; i++) {
+        integral[i] = 0;
+        last_err[i] = 0;
+    }
+    pid_clear();
+}
+
+void pid_setpoint(unsigned char *msg) {
+    unsigned char i;
+
+    for (i = 0; i < MOTOR_CMDLEN; i++) {
+        posted[i] = msg[i];
+    }
+    posted_new = 1;
+}
+
+static signed int pid_feedback(unsigned char loop) {
+#ifdef QUAD_ENCODERS
+    if (feedbacks[loop] >= PID_FB_ENC) {
+        return (enc_speed(feedbacks[loop] - PID_FB_ENC));
+    }
+#endif
+    if ((feedbacks[loop] == PID_FB_ADC) && (adcbuffer[0] != 0)) {
+        return ((signed int) adcbuffer[adcbuffer[0]] - 128);
+    }
+    return (0);
+}
+
+// one step of one loop, returning the drive value
+
+static signed int pid_step(unsigned char loop, signed int target) {
+    signed int err;
+    signed long drive;
+
+    if (feedbacks[loop] == PID_FB_NONE) {
+        return (target);
+    }
+    err = target - pid_feedback(loop);
+    integral[loop] += err;
+    if (integral[loop] > PID_INTEGRAL_MAX) {
+        integral[loop] = PID_INTEGRAL_MAX;
+    } else if (integral[loop] < -PID_INTEGRAL_MAX) {
+        integral[loop] = -PID_INTEGRAL_MAX;
+    }
+    drive = (signed long) kps[loop] * err
+            + (signed long) kis[loop] * integral[loop]
+            + (signed long) kds[loop] * (err - last_err[loop]);
+    drive >>= PID_GAIN_SHIFT;
+    last_err[loop] = err;
+    // don't let the integral wind up while the output is pinned
+    if (drive > PID_OUT_MAX) {
+        drive = PID_OUT_MAX;
+        integral[loop] -= err;
+    } else if (drive < -PID_OUT_MAX) {
+        drive = -PID_OUT_MAX;
+        integral[loop] -= err;
+    }
+    return ((signed int) drive);
+}
+
+void pid_tick() {
+    // timer1 has just overflowed, so its count is how long ago that was
+    unsigned int start = ReadTimer1();
+    unsigned char gieh = INTCONbits.GIEH;
+    unsigned char i;
+
+    INTCONbits.GIEH = 0;
+    if (posted_new) {
+        for (i = 0; i < MOTOR_CMDLEN; i++) {
+            cmd[i] = posted[i];
+        }
+        posted_new = 0;
+        running = 1;
+    }
+    INTCONbits.GIEH = gieh;
+    if (!running) {
+        return;
+    }
+
+    for (i = 0; i < MOTOR_CMDLEN; i++) {
+        sent[i] = cmd[i];
+    }
+    for (i = 0; i < NUM_PID_LOOPS; i++) {
+        sent[targets[i]] = (unsigned char) pid_step(i, (signed char) cmd[targets[i]]);
+    }
+    sent_ready = 1;
+    // get the transmit interrupt going if it isn't already
+    PIE1bits.TX1IE = 1;
+    // start the next ADC reading, to be ready for the next tick
+    if (!BusyADC()) {
+        ConvertADC();
+    }
+
+    ticks++;
+    if (start < late_min) {
+        late_min = start;
+    }
+    if (start > late_max) {
+        late_max = start;
+    }
+    exec_last = ReadTimer1() - start;
+    if (exec_last > exec_max) {
+        exec_max = exec_last;
+    }
+}
+
+signed char pid_next(unsigned char *buf) {
+    unsigned char i;
+
+    if (!sent_ready) {
+        return (0);
+    }
+    for (i = 0; i < MOTOR_CMDLEN; i++) {
+        buf[i] = sent[i];
+    }
+    sent_ready = 0;
+    return (MOTOR_CMDLEN);
+}
+
+unsigned char pid_report(unsigned char *buf) {
+    unsigned int words[PID_REPORTLEN / 2];
+    unsigned char i;
+
+    words[0] = ticks;
+    words[1] = exec_last;
+    words[2] = exec_max;
+    words[3] = late_min;
+    words[4] = late_max;
+    for (i = 0; i < PID_REPORTLEN / 2; i++) {
+        buf[2 * i] = words[i] & 0xFF;
+        buf[2 * i + 1] = words[i] >> 8;
+    }
+    return (PID_REPORTLEN);
+}
+
+void pid_clear() {
+    ticks = 0;
+    exec_last = 0;
+    exec_max = 0;
+    late_min = 0xFFFF;
+    late_max = 0;
+}
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef __pid_h
+#define __pid_h
+
+#include "motor_cmd.h"
+#include "encoder.h"
+
+// Motor speed loops (enabled with MOTOR_PID in maindefs.h, MOTORPIC only)
+//
+// A movement command no longer goes straight out of the UART.  Instead,
+// its payload bytes named in the table are taken as signed targets for
+// the loops, and on every timer1 interrupt each loop compares its target
+// with its feedback and works out a new drive value.  The command is then
+// sent on to the motor controller with those bytes replaced by the drive
+// values.  Nothing is sent until the first movement command arrives.
+//
+// Timer1 runs freely (it is the time base for latency.c), so the loops run
+// once per timer1 overflow: every 65536 counts, 43.7 ms on the J50 builds.
+// The gains are fixed point with PID_GAIN_SHIFT fraction bits and are per
+// tick, so they must be retuned if the period changes (which is why the
+// clock governor can't be used with them).
+//
+// Feedback is PID_FB_NONE (open loop: the target is the drive value),
+// PID_FB_ADC (the latest ADC reading, less 128) or, with QUAD_ENCODERS,
+// PID_FB_ENC plus an encoder (its speed, in counts per tick).
+//
+//      loop        target byte feedback                kp      ki      kd
+#ifdef QUAD_ENCODERS
+#define PID_LOOPS \
+    LOOP(PID_LEFT,  1,          PID_FB_ENC + ENC_LEFT,  0x0180, 0x0020, 0x0040) \
+    LOOP(PID_RIGHT, 2,          PID_FB_ENC + ENC_RIGHT, 0x0180, 0x0020, 0x0040)
+#else
+#define PID_LOOPS \
+    LOOP(PID_LEFT,  1,          PID_FB_ADC,             0x0180, 0x0020, 0x0040) \
+    LOOP(PID_RIGHT, 2,          PID_FB_NONE,            0,      0,      0)
+#endif
+
+#define PID_FB_NONE 0
+#define PID_FB_ADC 1
+#define PID_FB_ENC 2
+
+#define LOOP(name, target, feedback, kp, ki, kd) name,
+enum {
+    PID_LOOPS
+    NUM_PID_LOOPS
+};
+#undef LOOP
+
+#define PID_GAIN_SHIFT 8
+// drive values are limited to +/-PID_OUT_MAX and the integral to
+// +/-PID_INTEGRAL_MAX
+#define PID_OUT_MAX 127
+#define PID_INTEGRAL_MAX 4000
+
+// The reply to a 0xCF write (a non-zero second byte clears the counts
+// afterwards) is five little-endian words: ticks run, the last and the
+// longest time the loops took, and the shortest and longest time from the
+// timer1 overflow to the start of the loops (whose difference is the
+// jitter), all in timer1 counts.
+#define PID_REPORTLEN 10
+
+#ifdef MOTOR_PID
+void init_pid(void);
+// Called in place of queueing a movement command
+void pid_setpoint(unsigned char *);
+// Runs the loops, from the timer1 interrupt handler
+void pid_tick(void);
+// Called from the low priority (UART transmit) interrupt handler when it
+// has nothing else to send.  Copies the command with the latest drive
+// values into the buffer and returns its length, or 0 if there is none.
+signed char pid_next(unsigned char *);
+unsigned char pid_report(unsigned char *);
+void pid_clear(void);
+#else
+#define init_pid()
+#define pid_tick()
+#define pid_next(buf) (0)
+#endif
+
+#endif
@@ -0,0 +1,39 @@
+#include "maindefs.h"
+#include "my_uart.h"
+#include "motor_cmd.h"
+#include "regmap.h"
+
+#ifdef I2C_REGMAP
+
+volatile unsigned char regmap[REGMAP_LEN];
+static unsigned int frames;
+
+void init_regmap() {
+    unsigned char i;
+
+    for (i = 0; i < REGMAP_LEN; i++) {
+        regmap[i] = 0;
+    }
+    frames = 0;
+}
+
+void regmap_update(unsigned char *frame) {
+    unsigned char i;
+    unsigned char seq = regmap[REG_SEQ] + 1;
+
+    // The ends are written in the opposite order to how a burst reads them,
+    // so a burst that overlaps any part of this update sees two different
+    // sequence numbers
+    regmap[REG_SEQ_END] = seq;
+    for (i = 0; i < MAXUARTBUF; i++) {
+        regmap[REG_FRAME + i] = frame[i];
+    }
+    regmap[REG_MOTOR_APPLIED] = motor_cmd_applied();
+    regmap[REG_MOTOR_DEPTH] = motor_cmd_depth();
+    frames++;
+    regmap[REG_FRAMES] = frames & 0xFF;
+    regmap[REG_FRAMES + 1] = frames >> 8;
+    regmap[REG_SEQ] = seq;
+}
+
+#endif
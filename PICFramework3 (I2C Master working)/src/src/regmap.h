@@ -0,0 +1,40 @@
+#ifndef __regmap_h
+#define __regmap_h
+
+// Register-file view of the robot state (enabled with I2C_REGMAP in
+// maindefs.h)
+//
+// The command REGMAP_CMD, [0xDA, reg], sets the register pointer ([0xDA]
+// alone leaves it where it is).  Every read after that streams bytes out of
+// the map from the pointer on, one per byte clocked, wrapping back to
+// REG_SEQ at the end, so a master that always reads the whole map only has
+// to write the pointer once.  The 0xAA.. commands work as before, and each
+// frame still goes on to the 0xAB (or 0xBB) reply once it is in the map.
+//
+// Main updates the map while the slave may be in the middle of a burst, so
+// the map is framed by a sequence number at each end.  A burst from REG_SEQ
+// through REG_SEQ_END is a consistent snapshot if the two are equal, and
+// should be read again if not.
+
+#define REGMAP_CMD 0xDA
+
+#define REG_SEQ 0
+#define REG_FRAME 1             // the last UART frame, MAXUARTBUF bytes
+#define REG_MOTOR_APPLIED 6     // as in the 0xBA reply (see motor_cmd.h)
+#define REG_MOTOR_DEPTH 7
+#define REG_FRAMES 8            // frames received, little-endian word
+#define REG_SEQ_END 10
+#define REGMAP_LEN 11
+
+#ifdef I2C_REGMAP
+// read by the I2C handler, written only through regmap_update()
+extern volatile unsigned char regmap[REGMAP_LEN];
+
+void init_regmap(void);
+// Called from main with each new UART frame
+void regmap_update(unsigned char *);
+#else
+#define init_regmap()
+#endif
+
+#endif
@@ -0,0 +1,67 @@
+#include "maindefs.h"
+#include "messages.h"
+#include "my_uart.h"
+#include "tickless.h"
+#include "governor.h"
+
+// Each timer0 tick is one overflow of the low byte, so in 16-bit mode a
+// deadline of n ticks is n counts of TMR0H.
+static unsigned char t0_armed;
+static unsigned char t0_start;
+static unsigned char t1_enabled;
+
+void tickless_enter_idle() {
+    unsigned char ticks;
+    unsigned char low;
+
+    // nothing is scheduled on timer1 (unless the motor loops, encoder
+    // speeds, bus monitor windows or the master's missed data-ready edges
+    // are worked out on it), so don't let it wake us up
+    t1_enabled = PIE1bits.TMR1IE;
+#if !defined(MOTOR_PID) && !defined(QUAD_ENCODERS) && !(defined(I2C_BUS_MONITOR) && defined(I2CMASTER)) && !(defined(DATA_READY) && defined(I2CMASTER))
+    PIE1bits.TMR1IE = 0;
+#endif
+
+    if (uartTimeOut > UART_TIMEOUT) {
+        // the UART timeout has already expired, so there is no deadline
+        INTCONbits.TMR0IE = 0;
+        t0_armed = 0;
+        return;
+    }
+    ticks = UART_TIMEOUT + 1 - uartTimeOut;
+
+    // keep the partial tick in the low byte and count the rest in the high
+    // byte -- TMR0H is a buffer that is latched on any access to TMR0L, so
+    // the low byte must be read before TMR0H is written
+    T0CONbits.TMR0ON = 0;
+    low = TMR0L;
+    t0_start = 0 - ticks;
+    TMR0H = t0_start;
+    TMR0L = low;
+    T0CONbits.T08BIT = 0;
+    INTCONbits.TMR0IF = 0;
+    T0CONbits.TMR0ON = 1;
+    t0_armed = 1;
+}
+
+void tickless_exit_idle() {
+    unsigned char low;
+    unsigned char elapsed;
+
+    if (t0_armed) {
+        // TMR0H is latched on the read of TMR0L
+        T0CONbits.TMR0ON = 0;
+        low = TMR0L;
+        elapsed = TMR0H - t0_start;
+        TMR0L = low;
+        uartTimeOut += elapsed;
+        gov_ticks(elapsed);
+        T0CONbits.T08BIT = 1;
+        // the overflow (if that is what woke us) has been accounted for
+        INTCONbits.TMR0IF = 0;
+        T0CONbits.TMR0ON = 1;
+        t0_armed = 0;
+    }
+    INTCONbits.TMR0IE = 1;
+    PIE1bits.TMR1IE = t1_enabled;
+}
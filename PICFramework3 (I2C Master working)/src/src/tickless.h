@@ -0,0 +1,23 @@
+#ifndef __tickless_h
+#define __tickless_h
+
+// Tickless idle support (enabled with TICKLESS_IDLE in maindefs.h)
+//
+// While main() is blocked on its queues, timer0 and timer1 would normally
+// keep interrupting at a fixed rate and wake the processor every time.
+// Instead, just before sleeping, timer0 is switched to 16-bit mode and
+// preloaded so that it overflows exactly once at the next software deadline
+// (currently the UART frame timeout), and timer1 is left running with its
+// interrupt disabled (unless MOTOR_PID, QUAD_ENCODERS, or the master's
+// I2C_BUS_MONITOR or DATA_READY needs it).  After waking, the number of timer0 ticks
+// that passed is added back into uartTimeOut so the deadline logic never
+// notices.
+//
+// Both calls must be made from main() with GIEH cleared.
+
+// Reprogram the timers for the next deadline (or none)
+void tickless_enter_idle(void);
+// Account for the elapsed ticks and restore the periodic timers
+void tickless_exit_idle(void);
+
+#endif
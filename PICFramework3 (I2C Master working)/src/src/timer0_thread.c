@@ -7,10 +7,8 @@
 // of execution on the PIC because we are not using an RTOS.
 
 int timer0_lthread(timer0_thread_struct *tptr, int msgtype, int length, unsigned char *msgbuffer) {
-    unsigned int *msgval;
-
-    msgval = (unsigned int *) msgbuffer;
-
-    // Here is where we would do something with the message
+    // Here is where we would do something with the message, e.g. through
+    // (unsigned int *) msgbuffer
 
+    return (0);
 }
\ No newline at end of file
@@ -23,4 +23,5 @@ int timer1_lthread(timer1_thread_struct *tptr, int msgtype, int length, unsigned
             // We would handle the error here
         }
     }
+    return (0);
 }
\ No newline at end of file
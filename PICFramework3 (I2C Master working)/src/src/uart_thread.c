@@ -15,4 +15,5 @@ int uart_lthread(uart_thread_struct *uptr, int msgtype, int length, unsigned cha
         msgbuffer[length] = '\0'; // null-terminate the array as a string
         // Now we would do something with it
     }
+    return (0);
 }
\ No newline at end of file
@@ -9,12 +9,20 @@
 #endif
 #include "user_interrupts.h"
 #include "messages.h"
+#include "governor.h"
+#include "encoder.h"
+#include "odometry.h"
+#include "pid.h"
+#include "busmon.h"
+#include "dready.h"
+#include "warm.h"
 
 // A function called by the interrupt handler
 // This one does the action I wanted for this program on a timer0 interrupt
 
 void timer0_int_handler() {
     WriteTimer0(0);
+    gov_ticks(1);
 //    unsigned int val;
 //    int length, msgtype;
 
@@ -54,8 +62,14 @@ void timer1_int_handler() {
     //result = ReadTimer1();
     //ToMainLow_sendmsg(0, MSGT_TIMER1, (void *) 0);
 
-    // reset the timer
-    WriteTimer1(0);
+    // timer1 is left to run freely (it is the time base for latency.c),
+    // so it is not reset here
+    enc_tick();
+    odom_tick();
+    pid_tick();
+    busmon_tick();
+    dready_tick();
+    warm_tick();
 }
 
 void adc_int_handler(){
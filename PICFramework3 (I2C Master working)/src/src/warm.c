@@ -0,0 +1,137 @@
+#include "maindefs.h"
+#ifndef __XC8
+#include <timers.h>
+#else
+#include <plib/timers.h>
+#endif
+#include "motor_cmd.h"
+#include "regmap.h"
+#include "crc8.h"
+#include "warm.h"
+
+#ifdef WARM_RESTART
+
+#define WARM_MAGIC 0xA5
+
+#ifdef __XC8
+// persistent keeps it out of the RAM that the runtime startup clears
+static persistent warm_state warm;
+#else
+// the default (c018i) startup code leaves uninitialized data alone
+static warm_state warm;
+#endif
+static unsigned char cause;
+static unsigned char replied;
+// timer1 wraps since warm_boot(), up to WARM_MAX_WRAPS
+static unsigned char wraps;
+static unsigned char first_reply_wraps;
+static unsigned int first_reply;
+
+static unsigned char warm_crc() {
+    unsigned char *p = (unsigned char *) &warm;
+    unsigned char crc = CRC8_INIT;
+    unsigned char i;
+
+    for (i = 0; i < sizeof (warm_state) - 1; i++) {
+        crc = crc8_update(crc, p[i]);
+    }
+    return (crc);
+}
+
+unsigned char warm_boot() {
+    unsigned char i;
+
+    if (RCONbits.POR == 0) {
+        cause = WARM_COLD;
+    } else if (RCONbits.BOR == 0) {
+        cause = WARM_BOR;
+    } else if (RCONbits.TO == 0) {
+        cause = WARM_WDT;
+    } else {
+        cause = WARM_OTHER;
+    }
+    // set the flags up again for the next reset
+    RCONbits.POR = 1;
+    RCONbits.BOR = 1;
+    ClrWdt();
+
+    if ((cause == WARM_COLD) || (warm.magic != WARM_MAGIC)
+            || (warm.crc != warm_crc())) {
+        cause = WARM_COLD;
+        warm.magic = WARM_MAGIC;
+        for (i = 0; i < WARM_NUM_CAUSES; i++) {
+            warm.restarts[i] = 0;
+        }
+        for (i = 0; i < MAXUARTBUF; i++) {
+            warm.frame[i] = 0;
+        }
+        warm.motor_seq = 0;
+    } else {
+        warm.restarts[cause - 1]++;
+    }
+    warm.crc = warm_crc();
+    replied = 0;
+
+    // the time to the first reply is counted from here
+    wraps = 0;
+    WriteTimer1(0);
+    PIR1bits.TMR1IF = 0;
+    return (cause);
+}
+
+void warm_restore() {
+    motor_cmd_restore(warm.motor_seq);
+#ifdef I2C_REGMAP
+    regmap_update(warm.frame);
+#endif
+}
+
+void warm_save_frame(unsigned char *frame) {
+    unsigned char i;
+
+    for (i = 0; i < MAXUARTBUF; i++) {
+        warm.frame[i] = frame[i];
+    }
+    warm.crc = warm_crc();
+}
+
+void warm_save_motor(unsigned char seq) {
+    warm.motor_seq = seq;
+    warm.crc = warm_crc();
+}
+
+void warm_tick() {
+    if (!replied && (wraps < WARM_MAX_WRAPS)) {
+        wraps++;
+    }
+}
+
+void warm_first_reply() {
+    if (!replied) {
+        first_reply = ReadTimer1();
+        first_reply_wraps = wraps;
+        // a wrap that the timer1 handler has not got to yet
+        if (PIR1bits.TMR1IF && (first_reply < 0x8000)
+                && (first_reply_wraps < WARM_MAX_WRAPS)) {
+            first_reply_wraps++;
+        }
+        replied = 1;
+    }
+}
+
+unsigned char warm_report(unsigned char *buf) {
+    unsigned char i;
+
+    buf[0] = cause;
+    for (i = 0; i < WARM_NUM_CAUSES; i++) {
+        buf[2 * i + 1] = warm.restarts[i] & 0xFF;
+        buf[2 * i + 2] = warm.restarts[i] >> 8;
+    }
+    buf[7] = first_reply & 0xFF;
+    buf[8] = first_reply >> 8;
+    buf[9] = first_reply_wraps;
+    buf[10] = 0;
+    return (WARM_REPORTLEN);
+}
+
+#endif
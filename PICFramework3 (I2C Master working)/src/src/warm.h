@@ -0,0 +1,65 @@
+#ifndef __warm_h
+#define __warm_h
+
+#include "my_uart.h"
+
+// Warm restart (enabled with WARM_RESTART in maindefs.h)
+//
+// A little state is kept in RAM that the startup code does not clear, with
+// a CRC-8 over it.  After a reset that was not a power-on (watchdog,
+// brown-out, MCLR, RESET instruction, stack) the state is used again if the
+// CRC still matches: the last UART frame (back into the register map, with
+// I2C_REGMAP), the last movement command applied, and how many restarts of
+// each kind there have been.  The output latches also survive these
+// resets, so main() leaves them alone instead of clearing them.
+//
+// The UART handlers save the frame and the applied command as they go, so
+// the state is always at most one frame old.  A reset in the middle of a
+// save leaves a bad CRC and the next boot is cold.
+
+#define WARM_COLD 0
+#define WARM_WDT 1
+#define WARM_BOR 2
+#define WARM_OTHER 3
+#define WARM_NUM_CAUSES 3
+
+// The reply to a 0xCC write is the cause of the last reset, the number of
+// warm restarts for each cause (little-endian words, WDT, BOR, other) and
+// the timer1 counts from warm_boot() to the first I2C reply after it
+// (a little-endian long).  main() starts timer1 before warm_boot(), and
+// the wraps are counted by the timer1 handler, up to WARM_MAX_WRAPS (about
+// 11 s at 1.5 MHz); a reply later than that reads as at least that long.
+#define WARM_REPORTLEN 11
+#define WARM_MAX_WRAPS 0xFF
+
+typedef struct __warm_state {
+    unsigned char magic;
+    unsigned int restarts[WARM_NUM_CAUSES];
+    unsigned char frame[MAXUARTBUF];
+    unsigned char motor_seq;
+    unsigned char crc;
+} warm_state;
+
+#ifdef WARM_RESTART
+// Called first thing in main().  Returns what caused the reset, or
+// WARM_COLD if there was no saved state to trust.
+unsigned char warm_boot(void);
+// Called once the rest is initialized, after a boot that was not cold
+void warm_restore(void);
+// Called from the low priority (UART) interrupt handlers
+void warm_save_frame(unsigned char *);
+void warm_save_motor(unsigned char);
+// Called from the timer1 handler to count its wraps
+void warm_tick(void);
+void warm_first_reply(void);
+unsigned char warm_report(unsigned char *);
+#else
+#define warm_boot() WARM_COLD
+#define warm_restore()
+#define warm_save_frame(frame)
+#define warm_save_motor(seq)
+#define warm_tick()
+#define warm_first_reply()
+#endif
+
+#endif
@@ -0,0 +1,203 @@
+// Decodes a traffic capture dump (see src/capture.h) read from stdin, e.g.
+//     ./capdecode < /dev/ttyUSB0
+// with the port in raw mode at the rate the UART runs at, after sending
+// the sensor PIC a 0xCE.
+// Build on the host with "make capdecode" (see Makefile), or
+//     cc -I../src -o capdecode capdecode.c
+//
+// Each record is printed as the timer1 count it was handled at, the count
+// since the record before (assuming less than one timer1 wrap between
+// them) and what it was: the SSPSTAT flags and data byte of an I2C
+// interrupt, or a UART byte and its errors.  Under the records the I2C
+// interrupts are put back together into the transactions the slave saw,
+// e.g.
+//     write 9E: AB 01 05
+//     read  9E: 6 bytes
+// (the bytes the slave sent are not in the capture, only how many the
+// master clocked).  Anything before a dump header (other UART traffic) is
+// skipped.
+//
+// With -r the UART bytes are written to stdout instead, raw and spaced out
+// the way they were received, so a capture can be replayed into a sensor
+// PIC, e.g.
+//     ./capdecode -r < capture.bin > /dev/ttyUSB1
+// The spacing comes from the timer1 counts, so a gap of more than one
+// timer1 wrap (about 44 ms) is replayed short.
+// To replay a whole capture, the I2C side too, into a build of the
+// firmware on the simulator instead, see sim/replay.c.
+
+#define _DEFAULT_SOURCE
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include "capture.h"
+
+// timer1 runs from Fosc/4 with a 1:8 prescale on the J50 parts (main.c),
+// 1.5 MHz at 48 MHz
+#define CAP_TICK_NS 667
+
+// SSPSTAT as it is kept in the tag
+#define SSP_D_A 0x20
+#define SSP_P 0x10
+#define SSP_S 0x08
+#define SSP_R_W 0x04
+#define SSP_BF 0x01
+
+// the transaction being put back together
+static int in_trans;
+static int trans_read;
+static unsigned char trans_addr;
+static unsigned char trans_data[256];
+static int trans_len;
+static int trans_reads;
+
+static void trans_end(void) {
+    int i;
+
+    if (!in_trans) {
+        return;
+    }
+    if (trans_read) {
+        printf("        read  %02X: %d bytes\n", trans_addr, trans_reads);
+    } else {
+        printf("        write %02X:", trans_addr);
+        for (i = 0; i < trans_len; i++) {
+            printf(" %02X", trans_data[i]);
+        }
+        printf("\n");
+    }
+    in_trans = 0;
+}
+
+static void i2c_record(unsigned char tag, unsigned char data) {
+    if (tag & CAP_I2C_SSPOV) {
+        trans_end();
+        printf("        (receive overflow)\n");
+        return;
+    }
+    if ((tag & SSP_BF) && !(tag & SSP_D_A)) {
+        // an address: a (repeated) start of a new transaction
+        trans_end();
+        in_trans = 1;
+        trans_addr = data;
+        trans_read = (tag & SSP_R_W) != 0;
+        trans_len = 0;
+        // (the address interrupt of a read loads the first byte)
+        trans_reads = trans_read ? 1 : 0;
+        return;
+    }
+    if (!in_trans) {
+        return;
+    }
+    if (trans_read) {
+        if ((tag & SSP_D_A) && (tag & SSP_R_W)) {
+            trans_reads++;
+        } else {
+            trans_end();
+        }
+    } else if (tag & SSP_BF) {
+        if (trans_len < (int) sizeof (trans_data)) {
+            trans_data[trans_len++] = data;
+        }
+    } else if (tag & SSP_P) {
+        trans_end();
+    }
+}
+
+static void print_record(unsigned char *rec, unsigned int last) {
+    unsigned char tag = rec[0];
+    unsigned int stamp = rec[2] | (rec[3] << 8);
+
+    if (tag & CAP_UART) {
+        trans_end();
+    }
+    printf("%5u %6u  ", stamp, (stamp - last) & 0xFFFF);
+    if (tag & CAP_UART) {
+        printf("uart %02X%s%s\n", rec[1], (tag & 0x04) ? " FERR" : "",
+                (tag & 0x02) ? " OERR" : "");
+        return;
+    }
+    printf("i2c  %02X  %s%s%s%s%s%s\n", rec[1],
+            (tag & SSP_D_A) ? "D" : "A", (tag & SSP_S) ? " S" : "",
+            (tag & SSP_P) ? " P" : "", (tag & SSP_R_W) ? " R" : " W",
+            (tag & SSP_BF) ? " BF" : "", (tag & CAP_I2C_SSPOV) ? " SSPOV" : "");
+    i2c_record(tag, rec[1]);
+}
+
+static void replay_record(unsigned char *rec, unsigned int last, int first) {
+    unsigned int stamp = rec[2] | (rec[3] << 8);
+    struct timespec gap;
+    unsigned long ns;
+
+    if (!(rec[0] & CAP_UART)) {
+        return;
+    }
+    if (!first) {
+        ns = (unsigned long) ((stamp - last) & 0xFFFF) * CAP_TICK_NS;
+        gap.tv_sec = ns / 1000000000UL;
+        gap.tv_nsec = ns % 1000000000UL;
+        fflush(stdout);
+        nanosleep(&gap, 0);
+    }
+    putchar(rec[1]);
+}
+
+int main(int argc, char **argv) {
+    int replay = (argc > 1) && (strcmp(argv[1], "-r") == 0);
+    unsigned char rec[4];
+    unsigned int last = 0;
+    unsigned int last_uart = 0;
+    int first_uart = 1;
+    unsigned long skipped = 0;
+    int count, i, j, c;
+
+    while ((c = getchar()) != EOF) {
+        if (c != CAP_DUMP_MAGIC) {
+            skipped++;
+            continue;
+        }
+        if ((c = getchar()) != CAP_FORMAT) {
+            // (not a header, unless this byte starts one)
+            skipped++;
+            if (c != EOF) {
+                ungetc(c, stdin);
+            }
+            continue;
+        }
+        if ((count = getchar()) == EOF || (c = getchar()) == EOF) {
+            break;
+        }
+        if (!replay) {
+            if (skipped) {
+                printf("(%lu bytes skipped)\n", skipped);
+            }
+            printf("dump of %d records, %d overwritten before them\n", count, c);
+        }
+        skipped = 0;
+        for (i = 0; i < count; i++) {
+            for (j = 0; j < 4; j++) {
+                if ((c = getchar()) == EOF) {
+                    if (!replay) {
+                        printf("(dump cut short after %d records)\n", i);
+                    }
+                    trans_end();
+                    return 1;
+                }
+                rec[j] = c;
+            }
+            if (replay) {
+                replay_record(rec, last_uart, first_uart);
+                if (rec[0] & CAP_UART) {
+                    last_uart = rec[2] | (rec[3] << 8);
+                    first_uart = 0;
+                }
+            } else {
+                print_record(rec, last);
+            }
+            last = rec[2] | (rec[3] << 8);
+        }
+        trans_end();
+        fflush(stdout);
+    }
+    return 0;
+}
@@ -0,0 +1,127 @@
+// Runs the FRAME_DELTA coder in src/frame_delta.c round trip on the host:
+// the sensor PIC's encoder and the master's decoder, with the ack the
+// master writes back each time, [0xAB, 1, seq], carried between them the
+// way dready.c does it.  The frames are a slow random walk with now and
+// then a jump, a repeat or a burst of noise, and some replies are lost on
+// the way (so the master's ack goes stale) or cut short (so the decoder
+// has to refuse them and ask for a keyframe).  Every frame the decoder
+// accepts must be the one that was sent.  At the end the number of
+// keyframes and deltas, and the bytes they took, are printed.
+//
+// Build on the host with "make deltatest" (see Makefile), or
+//     cc -O2 -I../src -Isim/include -DFRAME_DELTA -DSMBUS_BLOCK -o deltatest deltatest.c ../src/frame_delta.c
+// and run it as
+//     ./deltatest [frames] [seed]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "frame_delta.h"
+
+// out of every 1000 replies
+#define LOST 20
+#define CUT 10
+
+static unsigned long rnd(void) {
+    static unsigned long long x = 88172645463325252ULL;
+
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    return ((unsigned long) (x >> 16));
+}
+
+static void next_frame(unsigned char *frame) {
+    unsigned char i;
+    unsigned long r = rnd() % 100;
+
+    if (r < 10) {
+        // the same again
+        return;
+    }
+    for (i = 0; i < MAXUARTBUF; i++) {
+        if (r < 15) {
+            frame[i] = (unsigned char) rnd();
+        } else if (rnd() % 4) {
+            frame[i] += (unsigned char) (rnd() % 9) - 4;
+        } else if (rnd() % 8 == 0) {
+            frame[i] += (unsigned char) (rnd() % 200) - 100;
+        }
+    }
+}
+
+int main(int argc, char **argv) {
+    unsigned long frames = (argc > 1) ? strtoul(argv[1], 0, 0) : 200000;
+    unsigned long n, i;
+    unsigned char sent[MAXUARTBUF] = {0};
+    unsigned char decoded[MAXUARTBUF] = {0};
+    unsigned char reply[FD_BUFLEN];
+    unsigned char ack = FD_NOSEQ;
+    unsigned char len, seq;
+    unsigned long keys = 0, deltas = 0, lost = 0, cut = 0, refused = 0;
+    unsigned long key_bytes = 0, delta_bytes = 0;
+    unsigned long failures = 0;
+
+    if (argc > 2) {
+        for (i = strtoul(argv[2], 0, 0); i > 0; i--) {
+            rnd();
+        }
+    }
+    init_frame_delta();
+    for (n = 0; n < frames; n++) {
+        next_frame(sent);
+        len = frame_delta_encode(sent, ack, reply);
+        if (len > FD_BUFLEN) {
+            printf("frame %lu: reply of %u bytes\n", n, len);
+            return (1);
+        }
+        if (reply[0] & FD_KEY) {
+            keys++;
+            key_bytes += len;
+        } else {
+            deltas++;
+            delta_bytes += len;
+        }
+
+        if (rnd() % 1000 < LOST) {
+            // the master never sees it and acks the old frame again
+            lost++;
+            continue;
+        }
+        if ((len > 1) && (rnd() % 1000 < CUT)) {
+            // (every code covers at least one byte of the frame, so a
+            // delta with any of its codes missing no longer covers it all)
+            cut++;
+            len = (unsigned char) (rnd() % len);
+        }
+        seq = frame_delta_decode(reply, len, decoded);
+        ack = seq;
+        if (seq == FD_NOSEQ) {
+            refused++;
+            continue;
+        }
+        if (memcmp(sent, decoded, MAXUARTBUF) != 0) {
+            failures++;
+            if (failures <= 10) {
+                printf("frame %lu: decoded", n);
+                for (i = 0; i < MAXUARTBUF; i++) {
+                    printf(" %02x/%02x", decoded[i], sent[i]);
+                }
+                printf("\n");
+            }
+        }
+    }
+
+    printf("%lu frames: %lu keyframes (%lu bytes), %lu deltas (%lu bytes)\n",
+            frames, keys, key_bytes, deltas, delta_bytes);
+    printf("%lu replies lost, %lu cut short, %lu refused by the decoder\n",
+            lost, cut, refused);
+    printf("%.2f bytes a frame, against %u for a keyframe\n",
+            (double) (key_bytes + delta_bytes) / frames, MAXUARTBUF + 1);
+    if (failures) {
+        printf("FAILED: %lu frames decoded wrong\n", failures);
+        return (1);
+    }
+    printf("all decoded frames matched\n");
+    return (0);
+}
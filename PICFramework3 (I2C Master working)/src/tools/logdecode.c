@@ -0,0 +1,63 @@
+// Decodes the binary event log (see src/binlog.h) read from stdin, e.g.
+//     ./logdecode < /dev/ttyUSB0
+// with the port in raw mode at the rate the UART runs at.
+// Build on the host with "make logdecode" (see Makefile), or
+//     cc -I../src -o logdecode logdecode.c
+//
+// Each record is printed as the timer1 count it was logged at, the count
+// since the record before (assuming less than one timer1 wrap between
+// them) and the event text.  Anything between records (other UART traffic)
+// is skipped, by resynchronizing on LOG_SYNC.
+
+#include <stdio.h>
+#include "binlog.h"
+
+#define LOG_EVENT(name, format) #name,
+static const char *names[NUM_LOG_EVENTS] = {
+    LOG_EVENTS
+};
+#undef LOG_EVENT
+
+#define LOG_EVENT(name, format) format,
+static const char *formats[NUM_LOG_EVENTS] = {
+    LOG_EVENTS
+};
+#undef LOG_EVENT
+
+int main(void) {
+    unsigned char rec[LOG_RECLEN];
+    unsigned int stamp;
+    unsigned int last = 0;
+    unsigned long skipped = 0;
+    int len = 0;
+    int c;
+
+    while ((c = getchar()) != EOF) {
+        rec[len++] = c;
+        if ((rec[0] != LOG_SYNC) || ((len > 1) && (rec[1] >= NUM_LOG_EVENTS))) {
+            // not a record -- look for the next sync byte
+            skipped += len;
+            len = 0;
+            if (c == LOG_SYNC) {
+                rec[len++] = c;
+                skipped--;
+            }
+            continue;
+        }
+        if (len < LOG_RECLEN) {
+            continue;
+        }
+        len = 0;
+        if (skipped) {
+            printf("(%lu bytes skipped)\n", skipped);
+            skipped = 0;
+        }
+        stamp = rec[2] | (rec[3] << 8);
+        printf("%5u %6u  %-16s ", stamp, (stamp - last) & 0xFFFF, names[rec[1]]);
+        printf(formats[rec[1]], rec[4], rec[5]);
+        printf("\n");
+        fflush(stdout);
+        last = stamp;
+    }
+    return 0;
+}
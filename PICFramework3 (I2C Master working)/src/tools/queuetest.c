@@ -0,0 +1,224 @@
+// Runs the message queues in src/messages.c on the host, built with
+// MSGQUEUE_HOST (C11 atomics), with a thread standing in for each
+// interrupt level and one for main(), each pinned to its own core where
+// there are enough of them:
+//     low  sends on ToMainLow and receives on FromMainLow
+//     high sends on ToMainHigh
+//     main receives on ToMainLow and ToMainHigh and sends on FromMainLow
+// Every queue still has one writer and one reader; the buffer pool is
+// shared by all of them.  Each message carries its sequence number and a
+// pattern made from it, and the reader checks both, so a message seen out
+// of order, twice, or before its data is a failure.  At the end the rate
+// is printed, along with how often a sender found its queue (or the pool)
+// full.
+//
+// Build on the host with "make queuetest" (see Makefile), or
+//     cc -std=c11 -O2 -pthread -DMSGQUEUE_HOST -I../src -o queuetest queuetest.c ../src/messages.c
+// and run it as
+//     ./queuetest [messages per queue]
+// For ThreadSanitizer add -fsanitize=thread -g (and use fewer messages).
+// To see what keeping the two queue indices on separate cache lines is
+// worth, build again with -DMSG_CACHE_ALIGN= and compare the rates.
+
+#define _GNU_SOURCE
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "messages.h"
+
+#define Q_LOW 0
+#define Q_HIGH 1
+#define Q_FROM_MAIN 2
+#define NUM_Q 3
+
+static unsigned long count;
+static unsigned long full[NUM_Q];
+static unsigned long pool_empty[NUM_Q];
+static atomic_ulong bad;
+// set before the threads start, if there is a core for each of them
+static int pinned;
+
+static void pin(int core) {
+#ifdef __linux__
+    cpu_set_t set;
+
+    if (pinned) {
+        CPU_ZERO(&set);
+        CPU_SET(core, &set);
+        pthread_setaffinity_np(pthread_self(), sizeof (set), &set);
+    }
+#endif
+}
+
+// With a core each the threads just spin; with fewer they have to give
+// the others a turn
+
+static void backoff(void) {
+    if (!pinned) {
+        sched_yield();
+    }
+}
+
+static void fill(unsigned char *data, unsigned char q, unsigned long seq) {
+    unsigned char i;
+
+    data[0] = seq & 0xFF;
+    data[1] = (seq >> 8) & 0xFF;
+    data[2] = (seq >> 16) & 0xFF;
+    data[3] = (seq >> 24) & 0xFF;
+    for (i = 4; i < MSGLEN; i++) {
+        data[i] = (seq * 31 + i * 7 + q) & 0xFF;
+    }
+}
+
+// the next message on a queue is sent (returns 1) or it is full
+
+static int send_next(unsigned char q, unsigned long seq) {
+    unsigned char data[MSGLEN];
+    signed char retval;
+
+    fill(data, q, seq);
+    switch (q) {
+        case Q_LOW: retval = ToMainLow_sendmsg(MSGLEN, q, data); break;
+        case Q_HIGH: retval = ToMainHigh_sendmsg(MSGLEN, q, data); break;
+        default: retval = FromMainLow_sendmsg(MSGLEN, q, data); break;
+    }
+    if (retval == MSGSEND_OKAY) {
+        return (1);
+    }
+    if (retval == MSGPOOL_EMPTY) {
+        pool_empty[q]++;
+    } else {
+        full[q]++;
+    }
+    return (0);
+}
+
+// checks a message that was received on queue q
+
+static void check(unsigned char q, signed char length, unsigned char msgtype,
+        unsigned char *data, unsigned long expected) {
+    unsigned char want[MSGLEN];
+    unsigned char i;
+
+    fill(want, q, expected);
+    if ((length != MSGLEN) || (msgtype != q)) {
+        bad++;
+        return;
+    }
+    for (i = 0; i < MSGLEN; i++) {
+        if (data[i] != want[i]) {
+            if (bad++ < 10) {
+                fprintf(stderr, "queue %u: message %lu byte %u is %u, not %u\n",
+                        q, expected, i, data[i], want[i]);
+            }
+            return;
+        }
+    }
+}
+
+static void *low_thread(void *arg) {
+    unsigned char data[MSGLEN];
+    unsigned char msgtype;
+    unsigned long sent = 0;
+    unsigned long received = 0;
+    signed char length;
+    int idle;
+
+    pin(1);
+    while ((sent < count) || (received < count)) {
+        idle = 1;
+        if ((sent < count) && send_next(Q_LOW, sent)) {
+            sent++;
+            idle = 0;
+        }
+        length = FromMainLow_recvmsg(MSGLEN, &msgtype, data);
+        if (length >= 0) {
+            check(Q_FROM_MAIN, length, msgtype, data, received++);
+            idle = 0;
+        }
+        if (idle) {
+            backoff();
+        }
+    }
+    return (arg);
+}
+
+static void *high_thread(void *arg) {
+    unsigned long sent = 0;
+
+    pin(2);
+    while (sent < count) {
+        if (send_next(Q_HIGH, sent)) {
+            sent++;
+        } else {
+            backoff();
+        }
+    }
+    return (arg);
+}
+
+int main(int argc, char **argv) {
+    pthread_t low;
+    pthread_t high;
+    unsigned char data[MSGLEN];
+    unsigned char msgtype;
+    unsigned long received[2] = {0, 0};
+    unsigned long sent = 0;
+    signed char length;
+    struct timespec t0;
+    struct timespec t1;
+    double secs;
+    unsigned char q;
+    int idle;
+
+    count = (argc > 1) ? strtoul(argv[1], 0, 0) : 1000000;
+    init_queues();
+#ifdef __linux__
+    pinned = (sysconf(_SC_NPROCESSORS_ONLN) >= NUM_Q);
+#endif
+    pin(0);
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    pthread_create(&low, 0, low_thread, 0);
+    pthread_create(&high, 0, high_thread, 0);
+    while ((received[Q_LOW] < count) || (received[Q_HIGH] < count) || (sent < count)) {
+        idle = 1;
+        length = ToMainHigh_recvmsg(MSGLEN, &msgtype, data);
+        if (length >= 0) {
+            check(Q_HIGH, length, msgtype, data, received[Q_HIGH]++);
+            idle = 0;
+        }
+        length = ToMainLow_recvmsg(MSGLEN, &msgtype, data);
+        if (length >= 0) {
+            check(Q_LOW, length, msgtype, data, received[Q_LOW]++);
+            idle = 0;
+        }
+        if ((sent < count) && send_next(Q_FROM_MAIN, sent)) {
+            sent++;
+            idle = 0;
+        }
+        if (idle) {
+            backoff();
+        }
+    }
+    pthread_join(low, 0);
+    pthread_join(high, 0);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+
+    secs = (t1.tv_sec - t0.tv_sec) + (t1.tv_nsec - t0.tv_nsec) / 1e9;
+    printf("%lu messages on each of %d queues in %.3f s: %.0f messages/s\n",
+            count, NUM_Q, secs, NUM_Q * count / secs);
+    for (q = 0; q < NUM_Q; q++) {
+        printf("queue %u: sender found it full %lu times, the pool empty %lu times\n",
+                q, full[q], pool_empty[q]);
+    }
+    if (bad) {
+        printf("FAILED: %lu messages out of order or corrupt\n", (unsigned long) bad);
+        return (1);
+    }
+    printf("all messages in order and intact\n");
+    return (0);
+}
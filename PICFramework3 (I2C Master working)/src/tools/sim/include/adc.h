@@ -0,0 +1,20 @@
+#ifndef __sim_adc_h
+#define __sim_adc_h
+
+// The A/D calls of the C18 peripheral library, for the simulator.  There
+// is nothing on the analogue inputs, so no conversion ever finishes.
+
+#define ADC_FOSC_16 0xFF
+#define ADC_LEFT_JUST 0x7F
+#define ADC_2_TAD 0xFF
+#define ADC_CH1 0x87
+#define ADC_INT_OFF 0x7F
+#define ADC_VREFPLUS_VDD 0xBF
+#define ADC_VREFMINUS_VSS 0xDF
+
+void OpenADC(unsigned char, unsigned char, unsigned short);
+void SetChanADC(unsigned char);
+void ConvertADC(void);
+char BusyADC(void);
+
+#endif
@@ -0,0 +1,13 @@
+#ifndef __sim_delays_h
+#define __sim_delays_h
+
+// The delay calls of the C18 library, for the simulator (see ../pic.c).
+// main() is charged for the time, and interrupts are taken during it.
+
+#ifdef TICKLESS_IDLE
+#error "the simulator cannot see main() set GIEH again after a tickless SLEEP"
+#endif
+
+void Delay1KTCYx(unsigned char);
+
+#endif
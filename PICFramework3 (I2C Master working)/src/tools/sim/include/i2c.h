@@ -0,0 +1,14 @@
+#ifndef __sim_i2c_h
+#define __sim_i2c_h
+
+// The I2C constants of the C18 peripheral library, for the simulator.  The
+// firmware drives the MSSP itself (see ../pic.c).
+
+#define SSPENB 0x20
+#define SLAVE_7 0x06
+#define SLAVE_10 0x07
+#define MASTER 0x08
+#define SLEW_OFF 0xC0
+#define SLEW_ON 0x00
+
+#endif
@@ -0,0 +1,338 @@
+#ifndef __sim_p18cxxx_h
+#define __sim_p18cxxx_h
+
+// Stands in for the C18 device header when the firmware is built into a
+// simulated PIC18F46J50 (see ../sim.c).  Each SFR the firmware uses is a
+// variable of pic.c's, with the real bit layout, and the peripherals are
+// brought up to date with them every time the simulated CPU stops (see
+// pic.c).  A handful of registers that the peripherals have to see being
+// read or written are reached through a function instead.
+
+#include <stdio.h>
+#include <string.h>
+
+// The PIC18 compilers have a 16-bit int, and the firmware counts on it
+// wrapping there (timer1 differences, for one).  Everything from the host
+// is included above, before it is changed.  long stays 64 bits, which only
+// makes a difference to struct layouts.
+#define int short
+
+// what C18 has that gcc hasn't
+#define rom
+#define _asm
+#define _endasm ;
+// (only used to jump from the interrupt vectors to the handlers, which
+// the simulator calls directly)
+#define goto (void)
+#define sleep sim_sleep();
+void sim_sleep(void);
+// (there is no watchdog)
+#define ClrWdt() ((void)0)
+// main() is called by the simulator
+#define main fw_main
+
+#ifndef SIM_SFR
+#define SIM_SFR extern
+#endif
+
+typedef union {
+    unsigned char byte;
+    struct {
+        unsigned char RBIF:1, INT0IF:1, TMR0IF:1, RBIE:1, INT0IE:1, TMR0IE:1, PEIE:1, GIE:1;
+    };
+    struct {
+        unsigned char :6, GIEL:1, GIEH:1;
+    };
+} sim_INTCONbits;
+SIM_SFR volatile sim_INTCONbits sim_INTCON;
+#define INTCON sim_INTCON.byte
+#define INTCONbits sim_INTCON
+
+typedef union {
+    unsigned char byte;
+    struct {
+        unsigned char RBIP:1, INT3IP:1, TMR0IP:1, INTEDG3:1, INTEDG2:1, INTEDG1:1, INTEDG0:1, RBPU:1;
+    };
+} sim_INTCON2bits;
+SIM_SFR volatile sim_INTCON2bits sim_INTCON2;
+#define INTCON2 sim_INTCON2.byte
+#define INTCON2bits sim_INTCON2
+
+typedef union {
+    unsigned char byte;
+    struct {
+        unsigned char INT1IF:1, INT2IF:1, INT3IF:1, INT1IE:1, INT2IE:1, INT3IE:1, INT1IP:1, INT2IP:1;
+    };
+} sim_INTCON3bits;
+SIM_SFR volatile sim_INTCON3bits sim_INTCON3;
+#define INTCON3 sim_INTCON3.byte
+#define INTCON3bits sim_INTCON3
+
+typedef union {
+    unsigned char byte;
+    struct {
+        unsigned char TMR1IF:1, TMR2IF:1, CCP1IF:1, SSPIF:1, TXIF:1, RCIF:1, ADIF:1, PMPIF:1;
+    };
+    struct {
+        unsigned char :3, SSP1IF:1, TX1IF:1, RC1IF:1;
+    };
+} sim_PIR1bits;
+SIM_SFR volatile sim_PIR1bits sim_PIR1;
+#define PIR1 sim_PIR1.byte
+#define PIR1bits sim_PIR1
+
+typedef union {
+    unsigned char byte;
+    struct {
+        unsigned char TMR1IE:1, TMR2IE:1, CCP1IE:1, SSPIE:1, TXIE:1, RCIE:1, ADIE:1, PMPIE:1;
+    };
+    struct {
+        unsigned char :3, SSP1IE:1, TX1IE:1, RC1IE:1;
+    };
+} sim_PIE1bits;
+SIM_SFR volatile sim_PIE1bits sim_PIE1;
+#define PIE1 sim_PIE1.byte
+#define PIE1bits sim_PIE1
+
+typedef union {
+    unsigned char byte;
+    struct {
+        unsigned char TMR1IP:1, TMR2IP:1, CCP1IP:1, SSPIP:1, TXIP:1, RCIP:1, ADIP:1, PMPIP:1;
+    };
+    struct {
+        unsigned char :3, SSP1IP:1, TX1IP:1, RC1IP:1;
+    };
+} sim_IPR1bits;
+SIM_SFR volatile sim_IPR1bits sim_IPR1;
+#define IPR1 sim_IPR1.byte
+#define IPR1bits sim_IPR1
+
+typedef union {
+    unsigned char byte;
+    struct {
+        unsigned char CCP2IF:1, TMR3IF:1, LVDIF:1, BCLIF:1, USBIF:1, CM1IF:1, CM2IF:1, OSCFIF:1;
+    };
+} sim_PIR2bits;
+SIM_SFR volatile sim_PIR2bits sim_PIR2;
+#define PIR2 sim_PIR2.byte
+#define PIR2bits sim_PIR2
+
+typedef union {
+    unsigned char byte;
+    struct {
+        unsigned char CCP2IE:1, TMR3IE:1, LVDIE:1, BCLIE:1, USBIE:1, CM1IE:1, CM2IE:1, OSCFIE:1;
+    };
+} sim_PIE2bits;
+SIM_SFR volatile sim_PIE2bits sim_PIE2;
+#define PIE2 sim_PIE2.byte
+#define PIE2bits sim_PIE2
+
+typedef union {
+    unsigned char byte;
+    struct {
+        unsigned char CCP2IP:1, TMR3IP:1, LVDIP:1, BCLIP:1, USBIP:1, CM1IP:1, CM2IP:1, OSCFIP:1;
+    };
+} sim_IPR2bits;
+SIM_SFR volatile sim_IPR2bits sim_IPR2;
+#define IPR2 sim_IPR2.byte
+#define IPR2bits sim_IPR2
+
+typedef union {
+    unsigned char byte;
+    struct {
+        unsigned char BOR:1, POR:1, PD:1, TO:1, RI:1, CM:1, :1, IPEN:1;
+    };
+} sim_RCONbits;
+SIM_SFR volatile sim_RCONbits sim_RCON;
+#define RCON sim_RCON.byte
+#define RCONbits sim_RCON
+
+typedef union {
+    unsigned char byte;
+    struct {
+        unsigned char SCS:2, :1, OSTS:1, IRCF:3, IDLEN:1;
+    };
+} sim_OSCCONbits;
+SIM_SFR volatile sim_OSCCONbits sim_OSCCON;
+#define OSCCON sim_OSCCON.byte
+#define OSCCONbits sim_OSCCON
+
+typedef union {
+    unsigned char byte;
+    struct {
+        unsigned char TUN:6, PLLEN:1, INTSRC:1;
+    };
+} sim_OSCTUNEbits;
+SIM_SFR volatile sim_OSCTUNEbits sim_OSCTUNE;
+#define OSCTUNE sim_OSCTUNE.byte
+#define OSCTUNEbits sim_OSCTUNE
+
+typedef union {
+    unsigned char byte;
+    struct {
+        unsigned char T0PS:3, PSA:1, T0SE:1, T0CS:1, T08BIT:1, TMR0ON:1;
+    };
+} sim_T0CONbits;
+SIM_SFR volatile sim_T0CONbits sim_T0CON;
+#define T0CON sim_T0CON.byte
+#define T0CONbits sim_T0CON
+
+typedef union {
+    unsigned char byte;
+    struct {
+        unsigned char TMR1ON:1, RD16:1, T1SYNC:1, T1OSCEN:1, T1CKPS:2, TMR1CS:2;
+    };
+} sim_T1CONbits;
+SIM_SFR volatile sim_T1CONbits sim_T1CON;
+#define T1CON sim_T1CON.byte
+#define T1CONbits sim_T1CON
+
+typedef union {
+    unsigned char byte;
+    struct {
+        unsigned char BF:1, UA:1, R_W:1, S:1, P:1, D_A:1, CKE:1, SMP:1;
+    };
+} sim_SSPSTATbits;
+SIM_SFR volatile sim_SSPSTATbits sim_SSPSTAT;
+#define SSPSTAT sim_SSPSTAT.byte
+#define SSPSTATbits sim_SSPSTAT
+
+typedef union {
+    unsigned char byte;
+    struct {
+        unsigned char SSPM:4, CKP:1, SSPEN:1, SSPOV:1, WCOL:1;
+    };
+} sim_SSPCON1bits;
+SIM_SFR volatile sim_SSPCON1bits sim_SSPCON1;
+#define SSPCON1 sim_SSPCON1.byte
+#define SSPCON1bits sim_SSPCON1
+
+typedef union {
+    unsigned char byte;
+    struct {
+        unsigned char SEN:1, RSEN:1, PEN:1, RCEN:1, ACKEN:1, ACKDT:1, ACKSTAT:1, GCEN:1;
+    };
+} sim_SSPCON2bits;
+SIM_SFR volatile sim_SSPCON2bits sim_SSPCON2;
+#define SSPCON2 sim_SSPCON2.byte
+#define SSPCON2bits sim_SSPCON2
+
+typedef union {
+    unsigned char byte;
+    struct {
+        unsigned char RX9D:1, OERR:1, FERR:1, ADDEN:1, CREN:1, SREN:1, RX9:1, SPEN:1;
+    };
+} sim_RCSTAbits;
+
+typedef union {
+    unsigned char byte;
+    struct {
+        unsigned char TX9D:1, TRMT:1, BRGH:1, SENDB:1, SYNC:1, TXEN:1, TX9:1, CSRC:1;
+    };
+} sim_TXSTAbits;
+SIM_SFR volatile sim_TXSTAbits sim_TXSTA;
+#define TXSTA sim_TXSTA.byte
+#define TXSTAbits sim_TXSTA
+#define TXSTA1 sim_TXSTA.byte
+#define TXSTA1bits sim_TXSTA
+
+typedef union {
+    unsigned char byte;
+    struct {
+        unsigned char ABDEN:1, WUE:1, :1, BRG16:1, TXCKP:1, RXDTP:1, RCIDL:1, ABDOVF:1;
+    };
+} sim_BAUDCONbits;
+SIM_SFR volatile sim_BAUDCONbits sim_BAUDCON1;
+#define BAUDCON1 sim_BAUDCON1.byte
+#define BAUDCON1bits sim_BAUDCON1
+
+typedef union {
+    unsigned char byte;
+    struct {
+        unsigned char PCFG8:1, PCFG9:1, PCFG10:1, PCFG11:1, PCFG12:1, :2, VBGEN:1;
+    };
+} sim_ANCON1bits;
+SIM_SFR volatile sim_ANCON1bits sim_ANCON1;
+#define ANCON1 sim_ANCON1.byte
+#define ANCON1bits sim_ANCON1
+
+// the ports, their latches and their direction (PORTB is what pic.c
+// drives the inputs of)
+#define SIM_PORT(port, p) \
+typedef union { \
+    unsigned char byte; \
+    struct { \
+        unsigned char p##0:1, p##1:1, p##2:1, p##3:1, p##4:1, p##5:1, p##6:1, p##7:1; \
+    }; \
+} sim_##port##bits; \
+SIM_SFR volatile sim_##port##bits sim_##port;
+
+SIM_PORT(PORTA, RA)
+SIM_PORT(LATA, LATA)
+SIM_PORT(TRISA, TRISA)
+SIM_PORT(LATB, LATB)
+SIM_PORT(TRISB, TRISB)
+SIM_PORT(PORTC, RC)
+SIM_PORT(LATC, LATC)
+SIM_PORT(TRISC, TRISC)
+#undef SIM_PORT
+
+typedef union {
+    unsigned char byte;
+    struct {
+        unsigned char RB0:1, RB1:1, RB2:1, RB3:1, RB4:1, RB5:1, RB6:1, RB7:1;
+    };
+    struct {
+        unsigned char :4, SCL1:1, SDA1:1;
+    };
+} sim_PORTBbits;
+SIM_SFR volatile sim_PORTBbits sim_PORTB;
+
+#define PORTA sim_PORTA.byte
+#define PORTAbits sim_PORTA
+#define LATA sim_LATA.byte
+#define LATAbits sim_LATA
+#define TRISA sim_TRISA.byte
+#define TRISAbits sim_TRISA
+#define PORTB sim_PORTB.byte
+#define PORTBbits sim_PORTB
+#define LATB sim_LATB.byte
+#define LATBbits sim_LATB
+#define TRISB sim_TRISB.byte
+#define TRISBbits sim_TRISB
+#define PORTC sim_PORTC.byte
+#define PORTCbits sim_PORTC
+#define LATC sim_LATC.byte
+#define LATCbits sim_LATC
+#define TRISC sim_TRISC.byte
+#define TRISCbits sim_TRISC
+
+// registers that are only ever used whole
+SIM_SFR volatile unsigned char TMR0L, TMR0H, TMR1L, TMR1H;
+SIM_SFR volatile unsigned char SPBRG1, SPBRGH1;
+SIM_SFR volatile unsigned char ADRESH, ADRESL, ADCON0, ADCON1;
+SIM_SFR volatile unsigned char RPINR1, RPINR2, RPINR3, PPSCON;
+
+// The MSSP has to see SSPBUF read (which clears BF) and written (which
+// starts a byte), so it holds 0x100 | the byte that the MSSP left there
+// until the firmware writes over it, and each use marks it as touched.
+// A write to SSPADD while SSPM is 1001 goes to SSPMSK, as on the J50s.
+volatile unsigned short *sim_sspbuf(void);
+volatile unsigned char *sim_sspadd(void);
+SIM_SFR volatile unsigned char SSPMSK;
+#define SSPBUF (*sim_sspbuf())
+#define SSPADD (*sim_sspadd())
+// the same for TXREG, and RCSTA, where clearing CREN clears OERR
+volatile unsigned short *sim_txreg(void);
+volatile sim_RCSTAbits *sim_rcsta(void);
+#define TXREG (*sim_txreg())
+#define TXREG1 (*sim_txreg())
+#define RCSTA (sim_rcsta()->byte)
+#define RCSTAbits (*sim_rcsta())
+#define RCSTA1 (sim_rcsta()->byte)
+#define RCSTA1bits (*sim_rcsta())
+
+// main.c calls the A/D library without including adc.h
+#include "adc.h"
+
+#endif
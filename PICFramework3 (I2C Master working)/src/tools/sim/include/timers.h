@@ -0,0 +1,48 @@
+#ifndef __sim_timers_h
+#define __sim_timers_h
+
+// The timer calls of the C18 peripheral library, for the simulator (see
+// ../pic.c).  Both timers count instruction cycles; pic.c decodes the
+// interrupt enable, the prescalers and timer0's width.
+
+#define TIMER_INT_ON 0xFF
+#define TIMER_INT_OFF 0x7F
+
+// the low bits are T0CON's (PSA and T0PS)
+#define T0_8BIT 0xFF
+#define T0_16BIT 0xBF
+#define T0_SOURCE_EXT 0xFF
+#define T0_SOURCE_INT 0xDF
+#define T0_PS_1_1 0xFF
+#define T0_PS_1_2 0xF0
+#define T0_PS_1_4 0xF1
+#define T0_PS_1_8 0xF2
+#define T0_PS_1_16 0xF3
+#define T0_PS_1_32 0xF4
+#define T0_PS_1_64 0xF5
+#define T0_PS_1_128 0xF6
+#define T0_PS_1_256 0xF7
+
+// the prescaler is in bits 5:4
+#define T1_16BIT_RW 0xFF
+#define T1_8BIT_RW 0xBF
+#define T1_PS_1_1 0xCF
+#define T1_PS_1_2 0xDF
+#define T1_PS_1_4 0xEF
+#define T1_PS_1_8 0xFF
+#define T1_OSC1EN_ON 0xFF
+#define T1_OSC1EN_OFF 0xF7
+#define T1_SYNC_EXT_ON 0xFB
+#define T1_SYNC_EXT_OFF 0xFF
+#define T1_SOURCE_EXT 0xFF
+#define T1_SOURCE_INT 0xFD
+#define T1_SOURCE_FOSC_4 0xFD
+
+void OpenTimer0(unsigned char);
+void WriteTimer0(unsigned short);
+unsigned short ReadTimer0(void);
+void OpenTimer1(unsigned char, unsigned char);
+void WriteTimer1(unsigned short);
+unsigned short ReadTimer1(void);
+
+#endif
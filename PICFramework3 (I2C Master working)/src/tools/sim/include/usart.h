@@ -0,0 +1,35 @@
+#ifndef __sim_usart_h
+#define __sim_usart_h
+
+// The EUSART calls of the C18 peripheral library, for the simulator (see
+// ../pic.c).  The configuration bits are ANDed together as in the library;
+// pic.c decodes the interrupt enables, BRGH and continuous receive.
+
+#define USART_TX_INT_ON 0xFF
+#define USART_TX_INT_OFF 0x7F
+#define USART_RX_INT_ON 0xFF
+#define USART_RX_INT_OFF 0xBF
+#define USART_BRGH_HIGH 0xFF
+#define USART_BRGH_LOW 0xEF
+#define USART_CONT_RX 0xFF
+#define USART_SINGLE_RX 0xF7
+#define USART_SYNC_MASTER 0xFF
+#define USART_SYNC_SLAVE 0xFB
+#define USART_NINE_BIT 0xFF
+#define USART_EIGHT_BIT 0xFD
+#define USART_SYNCH_MODE 0xFF
+#define USART_ASYNCH_MODE 0xFE
+
+typedef union {
+    unsigned char val;
+    struct {
+        unsigned char RX_NINE:1, TX_NINE:1, FRAME_ERROR:1, OVERRUN_ERROR:1, fill:4;
+    };
+} sim_USART_Status;
+extern sim_USART_Status USART1_Status;
+
+void Open1USART(unsigned char, unsigned char);
+char DataRdy1USART(void);
+char Read1USART(void);
+
+#endif
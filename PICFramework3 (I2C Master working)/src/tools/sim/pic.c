@@ -0,0 +1,934 @@
+// One simulated PIC18F46J50, for the simulator in sim.c: the SFRs and
+// library calls the firmware uses, the MSSP, EUSART and timers behind them,
+// and the CPU -- main() and the two interrupt priorities -- in simulated
+// time.  It is built into a shared object together with the firmware of
+// one role, so that every node has its own copy of everything.
+//
+// The firmware runs at host speed and simulated time only moves when it
+// stops: when main() gets to Delay1KTCYx(), after each interrupt, and at a
+// SLEEP.  At each of those the peripherals look at what the firmware did
+// to the SFRs since the last one (sync()), and an interrupt costs
+// isr_tcy instruction cycles and a pass of main() main_tcy, after which
+// what it did reaches the bus.  These costs are settings of sim.c, not
+// measurements; the host CPU time each handler takes is counted as well,
+// for comparing builds.  An interrupt handler runs to the end before the next one
+// is taken, so a high priority interrupt waits for a low priority handler
+// to finish instead of preempting it.
+
+#include <time.h>
+#include "sim.h"
+#define SIM_SFR
+#include <p18cxxx.h>
+#include <usart.h>
+#include <timers.h>
+#include <delays.h>
+#include <adc.h>
+#include <i2c.h>
+#undef int
+
+#define SIM_EXPORT __attribute__((visibility("default")))
+
+// the firmware's
+void fw_main(void);
+void InterruptHandlerHigh(void);
+void InterruptHandlerLow(void);
+unsigned short sleep_wakeups(void);
+unsigned short msg_pool_empty(void);
+unsigned char *msg_buf(unsigned char);
+// as in messages.h
+#define MSGSEND_OKAY 1
+
+sim_USART_Status USART1_Status;
+
+static const sim_host *host;
+static int self;
+static sim_pic_stats st;
+
+// what the CPU is doing: main(), a low or a high priority handler
+#define IN_MAIN 0
+#define IN_LOW 1
+#define IN_HIGH 2
+static int level;
+static int asleep;
+// the cost of the handler under way has been charged (by a SLEEP in it),
+// and the host CPU time at which it went to sleep
+static int isr_paid;
+static unsigned long long isr_paid_ns;
+
+//----------------------------------------------------------------------------
+// SFRs that are reached through a function
+
+static volatile unsigned short sspbuf = 0x100;
+static volatile unsigned char sspadd;
+static int sspbuf_touched;
+static volatile unsigned short txreg = 0x100;
+static int txreg_touched;
+static volatile sim_RCSTAbits rcsta;
+static int rcsta_touched;
+
+volatile unsigned short *sim_sspbuf(void) {
+    sspbuf_touched = 1;
+    return (&sspbuf);
+}
+
+volatile unsigned char *sim_sspadd(void) {
+    return ((SSPCON1bits.SSPM == 0x9) ? &SSPMSK : &sspadd);
+}
+
+volatile unsigned short *sim_txreg(void) {
+    txreg_touched = 1;
+    return (&txreg);
+}
+
+volatile sim_RCSTAbits *sim_rcsta(void) {
+    rcsta_touched = 1;
+    return (&rcsta);
+}
+
+//----------------------------------------------------------------------------
+// Interrupts
+
+// the enabled flags of one priority, whether or not that priority is
+// enabled (which is what wakes the CPU from SLEEP)
+
+static int flagged(int high) {
+    unsigned char ip = high ? 1 : 0;
+
+    if (INTCONbits.TMR0IE && INTCONbits.TMR0IF && (INTCON2bits.TMR0IP == ip)) {
+        return (1);
+    }
+    if (INTCON3bits.INT1IE && INTCON3bits.INT1IF && (INTCON3bits.INT1IP == ip)) {
+        return (1);
+    }
+    if (INTCON3bits.INT2IE && INTCON3bits.INT2IF && (INTCON3bits.INT2IP == ip)) {
+        return (1);
+    }
+    if (INTCON3bits.INT3IE && INTCON3bits.INT3IF && (INTCON2bits.INT3IP == ip)) {
+        return (1);
+    }
+    if (PIR1 & PIE1 & (high ? IPR1 : (unsigned char) ~IPR1)) {
+        return (1);
+    }
+    if (PIR2 & PIE2 & (high ? IPR2 : (unsigned char) ~IPR2)) {
+        return (1);
+    }
+    return (0);
+}
+
+// an interrupt of that priority would be taken now (the firmware always
+// runs with priorities, IPEN set)
+
+static int vectored(int high) {
+    if (!RCONbits.IPEN || !INTCONbits.GIEH) {
+        return (0);
+    }
+    if (high) {
+        return (flagged(1));
+    }
+    return (INTCONbits.GIEL && flagged(0));
+}
+
+static int wake(void) {
+    if (asleep) {
+        return (flagged(0) || flagged(1));
+    }
+    return ((level == IN_MAIN) && (vectored(1) || vectored(0)));
+}
+
+//----------------------------------------------------------------------------
+// MSSP
+
+static int master_mode(void) {
+    return (SSPCON1bits.SSPEN && (SSPCON1bits.SSPM == 0x8));
+}
+
+static int slave_mode(void) {
+    unsigned char m = SSPCON1bits.SSPM;
+
+    return (SSPCON1bits.SSPEN && ((m == 0x6) || (m == 0x7) || (m == 0xE) || (m == 0xF)));
+}
+
+// the operation this node's MSSP has on the bus, if any
+static int m_busy;
+// the slave has been addressed, and for a read
+static int s_addressed;
+static int s_reading;
+static int s_holding;
+
+// the baud rate generator counts SSPADD + 1 twice an instruction cycle for
+// each half of SCL, so Fscl = Fosc / (4 * (SSPADD + 1))
+
+static sim_time i2c_half_bit(void) {
+    return ((sim_time) (sspadd + 1) * 2);
+}
+
+static void i2c_done(int op, int acked, unsigned char data) {
+    m_busy = 0;
+    switch (op) {
+        case SIM_I2C_START:
+            SSPCON2bits.SEN = 0;
+            break;
+        case SIM_I2C_RESTART:
+            SSPCON2bits.RSEN = 0;
+            break;
+        case SIM_I2C_WRITE:
+            SSPSTATbits.BF = 0;
+            SSPCON2bits.ACKSTAT = !acked;
+            break;
+        case SIM_I2C_READ:
+            sspbuf = 0x100 | data;
+            SSPSTATbits.BF = 1;
+            SSPCON2bits.RCEN = 0;
+            break;
+        case SIM_I2C_ACK:
+            SSPCON2bits.ACKEN = 0;
+            break;
+        case SIM_I2C_STOP:
+            SSPCON2bits.PEN = 0;
+            break;
+    }
+    PIR1bits.SSPIF = 1;
+}
+
+// lost arbitration, or started while the bus was busy: the MSSP goes idle
+
+static void i2c_lost(void) {
+    m_busy = 0;
+    SSPCON2 &= 0xE0;
+    SSPSTATbits.BF = 0;
+    PIR2bits.BCLIF = 1;
+    st.collisions++;
+}
+
+static void i2c_start(void) {
+    SSPSTATbits.S = 1;
+    SSPSTATbits.P = 0;
+    s_addressed = 0;
+    if (slave_mode() && (SSPCON1bits.SSPM & 0x8)) {
+        // start and stop interrupts
+        PIR1bits.SSPIF = 1;
+    }
+}
+
+static void i2c_stop(void) {
+    SSPSTATbits.S = 0;
+    SSPSTATbits.P = 1;
+    s_addressed = 0;
+    if (slave_mode() && (SSPCON1bits.SSPM & 0x8)) {
+        PIR1bits.SSPIF = 1;
+    }
+}
+
+// a received byte that is not read in time is NACKed and sets SSPOV
+
+static int i2c_overrun(void) {
+    if (SSPSTATbits.BF || SSPCON1bits.SSPOV) {
+        SSPCON1bits.SSPOV = 1;
+        PIR1bits.SSPIF = 1;
+        st.sspov++;
+        return (1);
+    }
+    return (0);
+}
+
+// With SEN set the clock is stretched after every byte received, and it
+// always is after an address for a read and after each byte the master
+// ACKs, until the firmware sets CKP
+
+static int i2c_hold(void) {
+    SSPCON1bits.CKP = 0;
+    s_holding = 1;
+    return (SIM_I2C_HOLD);
+}
+
+static int i2c_address(unsigned char addr) {
+    if (!slave_mode() || (((addr ^ sspadd) & SSPMSK & 0xFE) != 0)) {
+        return (0);
+    }
+    if (i2c_overrun()) {
+        return (0);
+    }
+    sspbuf = 0x100 | addr;
+    SSPSTATbits.BF = 1;
+    SSPSTATbits.D_A = 0;
+    SSPSTATbits.R_W = addr & 1;
+    PIR1bits.SSPIF = 1;
+    s_addressed = 1;
+    s_reading = addr & 1;
+    if (s_reading || SSPCON2bits.SEN) {
+        return (SIM_I2C_ACKED | i2c_hold());
+    }
+    return (SIM_I2C_ACKED);
+}
+
+static int i2c_write(unsigned char data) {
+    if (!s_addressed || s_reading || i2c_overrun()) {
+        return (0);
+    }
+    sspbuf = 0x100 | data;
+    SSPSTATbits.BF = 1;
+    SSPSTATbits.D_A = 1;
+    PIR1bits.SSPIF = 1;
+    if (SSPCON2bits.SEN) {
+        return (SIM_I2C_ACKED | i2c_hold());
+    }
+    return (SIM_I2C_ACKED);
+}
+
+// the master clocks out whatever is in SSPBUF
+
+static unsigned char i2c_read(void) {
+    SSPSTATbits.BF = 0;
+    return (sspbuf & 0xFF);
+}
+
+static int i2c_ack(int nack) {
+    if (!s_addressed || !s_reading) {
+        return (0);
+    }
+    SSPSTATbits.D_A = 1;
+    PIR1bits.SSPIF = 1;
+    if (nack) {
+        // R_W only holds until the master's NACK
+        SSPSTATbits.R_W = 0;
+        return (0);
+    }
+    SSPSTATbits.R_W = 1;
+    return (i2c_hold());
+}
+
+//----------------------------------------------------------------------------
+// EUSART
+
+#define RX_FIFO 2
+static unsigned char rx_fifo[RX_FIFO];
+static unsigned char rx_ferr[RX_FIFO];
+static int rx_count;
+// the shift register is busy, and TXREG is waiting behind it
+static int tsr_busy;
+static int txreg_full;
+static unsigned char txreg_next;
+
+static sim_time uart_bit(void) {
+    unsigned long div;
+
+    if (!rcsta.SPEN) {
+        return (0);
+    }
+    if (BAUDCON1bits.BRG16) {
+        div = TXSTAbits.BRGH ? 4 : 16;
+    } else {
+        div = TXSTAbits.BRGH ? 16 : 64;
+    }
+    return ((sim_time) div * (((SPBRGH1 << 8) | SPBRG1) + 1));
+}
+
+void Open1USART(unsigned char config, unsigned char spbrg) {
+    SPBRG1 = spbrg;
+    SPBRGH1 = 0;
+    TXSTAbits.BRGH = (config & 0x10) ? 1 : 0;
+    TXSTAbits.TXEN = 1;
+    TXSTAbits.TRMT = 1;
+    rcsta.CREN = (config & 0x08) ? 1 : 0;
+    rcsta.SPEN = 1;
+    PIR1bits.TXIF = 1;
+    PIE1bits.TXIE = (config & 0x80) ? 1 : 0;
+    PIE1bits.RCIE = (config & 0x40) ? 1 : 0;
+}
+
+char DataRdy1USART(void) {
+    return (rx_count > 0);
+}
+
+char Read1USART(void) {
+    unsigned char data;
+
+    USART1_Status.val &= 0xF2;
+    if (rcsta.FERR) {
+        USART1_Status.FRAME_ERROR = 1;
+    }
+    if (rcsta.OERR) {
+        USART1_Status.OVERRUN_ERROR = 1;
+    }
+    if (rx_count == 0) {
+        return (0);
+    }
+    data = rx_fifo[0];
+    rx_fifo[0] = rx_fifo[1];
+    rx_ferr[0] = rx_ferr[1];
+    rx_count--;
+    // FERR goes with the byte at the top of the FIFO
+    rcsta.FERR = (rx_count > 0) ? rx_ferr[0] : 0;
+    PIR1bits.RCIF = (rx_count > 0);
+    return (data);
+}
+
+// the receiver stops while OERR is set
+
+static void uart_rx(unsigned char data, int errs) {
+    if (!rcsta.SPEN || !rcsta.CREN || rcsta.OERR) {
+        return;
+    }
+    st.rx_bytes++;
+    if (rx_count == RX_FIFO) {
+        rcsta.OERR = 1;
+        st.rx_overruns++;
+        return;
+    }
+    rx_ferr[rx_count] = (errs & SIM_UART_FERR) ? 1 : 0;
+    rx_fifo[rx_count++] = data;
+    rcsta.FERR = rx_ferr[0];
+    if (errs & SIM_UART_OERR) {
+        // (the byte that was lost is not there to be read)
+        rcsta.OERR = 1;
+        st.rx_overruns++;
+    }
+    PIR1bits.RCIF = 1;
+}
+
+static void uart_shift(unsigned char data) {
+    tsr_busy = 1;
+    TXSTAbits.TRMT = 0;
+    st.tx_bytes++;
+    host->uart_tx(self, data, uart_bit());
+}
+
+//----------------------------------------------------------------------------
+// Timers, both counting instruction cycles
+
+static sim_time t0_base;
+static unsigned t0_gen;
+static sim_time t1_base;
+static unsigned t1_gen;
+
+static sim_time t0_tick(void) {
+    return (T0CONbits.PSA ? SIM_TCY : (sim_time) SIM_TCY << (T0CONbits.T0PS + 1));
+}
+
+static sim_time t0_period(void) {
+    return (t0_tick() * (T0CONbits.T08BIT ? 256 : 65536));
+}
+
+static void t0_schedule(void) {
+    t0_gen++;
+    if (T0CONbits.TMR0ON) {
+        host->at(self, t0_base + t0_period(), SIM_EV_TMR0, t0_gen);
+    }
+}
+
+void OpenTimer0(unsigned char config) {
+    T0CON = config & 0x7F;
+    INTCONbits.TMR0IF = 0;
+    INTCONbits.TMR0IE = (config & 0x80) ? 1 : 0;
+    T0CONbits.TMR0ON = 1;
+    t0_base = host->now();
+    t0_schedule();
+}
+
+void WriteTimer0(unsigned short count) {
+    if (T0CONbits.T08BIT) {
+        count &= 0xFF;
+    }
+    t0_base = host->now() - count * t0_tick();
+    t0_schedule();
+}
+
+unsigned short ReadTimer0(void) {
+    return ((host->now() - t0_base) / t0_tick());
+}
+
+static sim_time t1_tick(void) {
+    return ((sim_time) SIM_TCY << T1CONbits.T1CKPS);
+}
+
+static void t1_schedule(void) {
+    t1_gen++;
+    host->at(self, t1_base + 65536 * t1_tick(), SIM_EV_TMR1, t1_gen);
+}
+
+void OpenTimer1(unsigned char config, unsigned char config1) {
+    (void) config1;
+    T1CONbits.T1CKPS = (config >> 4) & 3;
+    T1CONbits.TMR1ON = 1;
+    PIR1bits.TMR1IF = 0;
+    PIE1bits.TMR1IE = (config & 0x80) ? 1 : 0;
+    t1_base = host->now();
+    t1_schedule();
+}
+
+void WriteTimer1(unsigned short count) {
+    t1_base = host->now() - count * t1_tick();
+    t1_schedule();
+}
+
+unsigned short ReadTimer1(void) {
+    return ((host->now() - t1_base) / t1_tick());
+}
+
+static void event(int kind, unsigned arg) {
+    switch (kind) {
+        case SIM_EV_TMR0:
+            if (arg == t0_gen) {
+                INTCONbits.TMR0IF = 1;
+                t0_base += t0_period();
+                t0_schedule();
+            }
+            break;
+        case SIM_EV_TMR1:
+            if (arg == t1_gen) {
+                PIR1bits.TMR1IF = 1;
+                t1_base += 65536 * t1_tick();
+                t1_schedule();
+            }
+            break;
+        case SIM_EV_TXDONE:
+            tsr_busy = 0;
+            TXSTAbits.TRMT = 1;
+            if (txreg_full) {
+                txreg_full = 0;
+                PIR1bits.TXIF = 1;
+                uart_shift(txreg_next);
+            }
+            break;
+    }
+}
+
+//----------------------------------------------------------------------------
+// A/D (nothing is connected) and delays
+
+void OpenADC(unsigned char config, unsigned char config2, unsigned short portconfig) {
+    (void) config;
+    (void) config2;
+    (void) portconfig;
+}
+
+void SetChanADC(unsigned char channel) {
+    (void) channel;
+}
+
+void ConvertADC(void) {
+}
+
+char BusyADC(void) {
+    return (0);
+}
+
+//----------------------------------------------------------------------------
+// Pins: PORTB is driven by the other nodes, and an edge on a pin that is
+// mapped to INT1-3 (RB0-7 are RP3-10) sets its flag
+
+static void pin_in(int pin, int level_in) {
+    unsigned char bit = 1 << pin;
+    int rose = level_in && !(PORTB & bit);
+    int fell = !level_in && (PORTB & bit);
+    unsigned char rp = pin + 3;
+
+    if (level_in) {
+        PORTB |= bit;
+    } else {
+        PORTB &= ~bit;
+    }
+    if ((RPINR1 == rp) && (INTCON2bits.INTEDG1 ? rose : fell)) {
+        INTCON3bits.INT1IF = 1;
+    }
+    if ((RPINR2 == rp) && (INTCON2bits.INTEDG2 ? rose : fell)) {
+        INTCON3bits.INT2IF = 1;
+    }
+    if ((RPINR3 == rp) && (INTCON2bits.INTEDG3 ? rose : fell)) {
+        INTCON3bits.INT3IF = 1;
+    }
+}
+
+//----------------------------------------------------------------------------
+// Catching up with the firmware
+//
+// sync() looks at the SFRs as soon as the firmware stops, and flush()
+// passes on what it found once the time that took has been charged.
+
+#define MAX_ACTIONS 8
+static struct {
+    int what;
+    int op;
+    unsigned char data;
+} actions[MAX_ACTIONS];
+static int num_actions;
+static unsigned char last_latb;
+
+enum {
+    ACT_I2C,
+    ACT_RELEASE,
+    ACT_TX,
+    ACT_PIN
+};
+
+static void act(int what, int op, unsigned char data) {
+    if (num_actions < MAX_ACTIONS) {
+        actions[num_actions].what = what;
+        actions[num_actions].op = op;
+        actions[num_actions].data = data;
+        num_actions++;
+    }
+}
+
+static void master_op(int op, unsigned char data) {
+    m_busy = 1;
+    act(ACT_I2C, op, data);
+}
+
+static void sync_mssp(void) {
+    int written = 0;
+    unsigned char data = 0;
+
+    if (sspbuf_touched) {
+        sspbuf_touched = 0;
+        if (sspbuf & 0x100) {
+            // only read
+            SSPSTATbits.BF = 0;
+        } else {
+            written = 1;
+            data = sspbuf;
+            sspbuf |= 0x100;
+        }
+    }
+    if (master_mode()) {
+        if (m_busy) {
+            if (written) {
+                SSPCON1bits.WCOL = 1;
+            }
+        } else if (SSPCON2bits.SEN) {
+            master_op(SIM_I2C_START, 0);
+        } else if (SSPCON2bits.RSEN) {
+            master_op(SIM_I2C_RESTART, 0);
+        } else if (SSPCON2bits.PEN) {
+            master_op(SIM_I2C_STOP, 0);
+        } else if (SSPCON2bits.RCEN) {
+            master_op(SIM_I2C_READ, 0);
+        } else if (SSPCON2bits.ACKEN) {
+            master_op(SIM_I2C_ACK, SSPCON2bits.ACKDT);
+        } else if (written) {
+            SSPSTATbits.BF = 1;
+            master_op(SIM_I2C_WRITE, data);
+        }
+    } else if (slave_mode()) {
+        if (written) {
+            // loaded for the master to read
+            SSPSTATbits.BF = 1;
+        }
+        if (s_holding && SSPCON1bits.CKP) {
+            s_holding = 0;
+            act(ACT_RELEASE, 0, 0);
+        }
+    }
+}
+
+static void sync_uart(void) {
+    unsigned char data;
+
+    if (txreg_touched) {
+        txreg_touched = 0;
+        if (!(txreg & 0x100)) {
+            data = txreg;
+            txreg |= 0x100;
+            if (!tsr_busy) {
+                tsr_busy = 1;
+                TXSTAbits.TRMT = 0;
+                act(ACT_TX, 0, data);
+            } else {
+                txreg_full = 1;
+                txreg_next = data;
+                PIR1bits.TXIF = 0;
+            }
+        }
+    }
+    if (rcsta_touched) {
+        rcsta_touched = 0;
+        // (CREN is cleared and set again to clear OERR)
+        if (rcsta.CREN) {
+            rcsta.OERR = 0;
+        }
+    }
+}
+
+static void sync(void) {
+    unsigned char changed;
+    int pin;
+
+    sync_mssp();
+    sync_uart();
+    changed = (LATB ^ last_latb) & ~TRISB;
+    last_latb = LATB;
+    for (pin = 0; pin < 8; pin++) {
+        if (changed & (1 << pin)) {
+            act(ACT_PIN, pin, (LATB >> pin) & 1);
+        }
+    }
+}
+
+static void flush(void) {
+    int i;
+
+    for (i = 0; i < num_actions; i++) {
+        switch (actions[i].what) {
+            case ACT_I2C:
+                host->i2c_op(self, actions[i].op, actions[i].data);
+                break;
+            case ACT_RELEASE:
+                host->i2c_release(self);
+                break;
+            case ACT_TX:
+                uart_shift(actions[i].data);
+                break;
+            case ACT_PIN:
+                host->pin(self, actions[i].op, actions[i].data);
+                break;
+        }
+    }
+    num_actions = 0;
+}
+
+//----------------------------------------------------------------------------
+// Messages
+
+// The Makefile links the firmware with --wrap for its sends to main() and
+// along the routes, so they come here, and on to the host once the queue
+// has had them.  (Weak, so that a build without the flags still loads.)
+signed char __real_ToMainHigh_sendmsg(unsigned char, unsigned char, void *) __attribute__((weak));
+signed char __real_ToMainLow_sendmsg(unsigned char, unsigned char, void *) __attribute__((weak));
+signed char __real_ToMainLow_sendbuf(unsigned char, unsigned char, unsigned char) __attribute__((weak));
+signed char __real_route_sendmsg(unsigned char, unsigned char, unsigned char, void *) __attribute__((weak));
+signed char __real_route_sendbuf(unsigned char, unsigned char, unsigned char, unsigned char) __attribute__((weak));
+
+static signed char sent(int queue, signed char retval, unsigned char msgtype,
+        unsigned char length, const void *data) {
+    if (host->message) {
+        host->message(self, queue, retval == MSGSEND_OKAY, msgtype, length, data);
+    }
+    return (retval);
+}
+
+signed char __wrap_ToMainHigh_sendmsg(unsigned char length, unsigned char msgtype, void *data) {
+    return (sent(SIM_MSG_TO_MAIN_HIGH, __real_ToMainHigh_sendmsg(length, msgtype, data),
+            msgtype, length, data));
+}
+
+signed char __wrap_ToMainLow_sendmsg(unsigned char length, unsigned char msgtype, void *data) {
+    return (sent(SIM_MSG_TO_MAIN_LOW, __real_ToMainLow_sendmsg(length, msgtype, data),
+            msgtype, length, data));
+}
+
+// (a buffer that was sent belongs to the queue now, but nothing can take
+// it off the queue before the host has looked at it)
+
+signed char __wrap_ToMainLow_sendbuf(unsigned char length, unsigned char msgtype, unsigned char buf) {
+    return (sent(SIM_MSG_TO_MAIN_LOW, __real_ToMainLow_sendbuf(length, msgtype, buf),
+            msgtype, length, msg_buf(buf)));
+}
+
+signed char __wrap_route_sendmsg(unsigned char route, unsigned char length, unsigned char msgtype,
+        void *data) {
+    return (sent(SIM_MSG_ROUTE + route, __real_route_sendmsg(route, length, msgtype, data),
+            msgtype, length, data));
+}
+
+signed char __wrap_route_sendbuf(unsigned char route, unsigned char length, unsigned char msgtype,
+        unsigned char buf) {
+    return (sent(SIM_MSG_ROUTE + route, __real_route_sendbuf(route, length, msgtype, buf),
+            msgtype, length, msg_buf(buf)));
+}
+
+//----------------------------------------------------------------------------
+// The CPU
+
+// busy for that many cycles, with nothing taken in between
+
+static void spend(unsigned long tcy) {
+    host->wait(self, host->now() + (sim_time) tcy * SIM_TCY, 0);
+}
+
+// host CPU time of this thread, in ns, and the least that reading it twice
+// takes (which comes off every handler's time)
+
+static unsigned long long cpu_ns_cost;
+
+static unsigned long long cpu_ns(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return ((unsigned long long) ts.tv_sec * 1000000000ULL + ts.tv_nsec);
+}
+
+static void cpu_ns_calibrate(void) {
+    unsigned long long ns;
+    int i;
+
+    cpu_ns_cost = ~0ULL;
+    for (i = 0; i < 1000; i++) {
+        ns = cpu_ns();
+        ns = cpu_ns() - ns;
+        if (ns < cpu_ns_cost) {
+            cpu_ns_cost = ns;
+        }
+    }
+}
+
+static void run_isr(int high) {
+    sim_time start = host->now();
+    sim_time slept = st.sleep_time;
+    int was = level;
+    int ssp = PIR1bits.SSPIF && PIE1bits.SSPIE && (IPR1bits.SSPIP == high);
+    unsigned long long ns;
+
+    isr_paid = 0;
+    ns = cpu_ns();
+    if (high) {
+        st.isr_high++;
+        INTCONbits.GIEH = 0;
+        level = IN_HIGH;
+        InterruptHandlerHigh();
+    } else {
+        st.isr_low++;
+        INTCONbits.GIEL = 0;
+        level = IN_LOW;
+        InterruptHandlerLow();
+    }
+    // (the time asleep at the end of InterruptHandlerHigh() is not its own)
+    ns = (isr_paid ? isr_paid_ns : cpu_ns()) - ns;
+    ns -= (ns > cpu_ns_cost) ? cpu_ns_cost : ns;
+    if (high) {
+        st.isr_high_ns += ns;
+    } else {
+        st.isr_low_ns += ns;
+    }
+    if (ssp) {
+        st.ssp_isrs++;
+        st.ssp_ns += ns;
+        ns /= SIM_NS_BUCKET;
+        st.ssp_ns_hist[(ns < SIM_NS_BUCKETS) ? ns : SIM_NS_BUCKETS - 1]++;
+    }
+    sync();
+    if (!isr_paid) {
+        spend(host->isr_tcy);
+    }
+    flush();
+    if (high) {
+        INTCONbits.GIEH = 1;
+    } else {
+        INTCONbits.GIEL = 1;
+    }
+    level = was;
+    st.isr_time += (host->now() - start) - (st.sleep_time - slept);
+}
+
+static void service(void) {
+    for (;;) {
+        if (vectored(1)) {
+            run_isr(1);
+        } else if (vectored(0)) {
+            run_isr(0);
+        } else {
+            return;
+        }
+    }
+}
+
+// main() runs for that many cycles, less the time taken by interrupts
+
+static void main_run(unsigned long tcy) {
+    sim_time left = (sim_time) tcy * SIM_TCY;
+    sim_time start;
+    sim_time ran;
+
+    sync();
+    flush();
+    for (;;) {
+        service();
+        if (left == 0) {
+            return;
+        }
+        start = host->now();
+        host->wait(self, start + left, 1);
+        ran = host->now() - start;
+        left -= (ran < left) ? ran : left;
+    }
+}
+
+void Delay1KTCYx(unsigned char count) {
+    main_run(host->main_tcy + 1000UL * count);
+}
+
+// SLEEP (in IDLE mode, so the peripherals keep going): any enabled flag
+// wakes the CPU, whether or not its priority is enabled
+
+void sim_sleep(void) {
+    sim_time start;
+
+    if (level != IN_MAIN) {
+        isr_paid_ns = cpu_ns();
+    }
+    sync();
+    if (level != IN_MAIN) {
+        spend(host->isr_tcy);
+        isr_paid = 1;
+    }
+    flush();
+    st.sleeps++;
+    start = host->now();
+    asleep = 1;
+    while (!flagged(0) && !flagged(1)) {
+        host->wait(self, SIM_FOREVER, 1);
+    }
+    asleep = 0;
+    st.sleep_time += host->now() - start;
+}
+
+static void run(void) {
+    fw_main();
+    // (main() never returns on the PIC)
+    for (;;) {
+        host->wait(self, SIM_FOREVER, 0);
+    }
+}
+
+static void stats(sim_pic_stats *sp) {
+    *sp = st;
+    sp->wakeups = sleep_wakeups();
+    sp->pool_empty = msg_pool_empty();
+}
+
+static const sim_pic pic = {
+    run,
+    wake,
+    event,
+    i2c_half_bit,
+    i2c_done,
+    i2c_lost,
+    i2c_start,
+    i2c_address,
+    i2c_write,
+    i2c_read,
+    i2c_ack,
+    i2c_stop,
+    uart_rx,
+    uart_bit,
+    pin_in,
+    stats
+};
+
+// reset values, for the registers where they matter
+
+SIM_EXPORT const sim_pic *sim_pic_init(const sim_host *h, int node) {
+    host = h;
+    self = node;
+    RCON = 0x1F;
+    INTCON2 = 0xFF;
+    INTCON3 = 0xC0;
+    IPR1 = 0xFF;
+    IPR2 = 0xFF;
+    TRISA = 0xFF;
+    TRISB = 0xFF;
+    TRISC = 0xFF;
+    SSPMSK = 0xFF;
+    TXSTAbits.TRMT = 1;
+    cpu_ns_calibrate();
+    return (&pic);
+}
@@ -0,0 +1,702 @@
+// Replays a traffic capture (see src/capture.h) into a slave PIC on the
+// simulator's PIC (pic.c) and scheduler (simsched.c), so a capture taken
+// from the field can be run against another build of the firmware.  Each
+// record is fed in at its timer1 count: a UART record as the byte (and its
+// FERR and OERR) arriving at the EUSART, an I2C record as the bus events
+// that raised that SSPIF:
+//
+//     address (BF, not D_A)        a start, if there was no start record
+//                                  before it, and the address
+//     start (S alone)              a start
+//     data (D_A, BF, write)        a byte written
+//     data (D_A, read)             the master reading a byte and ACKing it
+//     data (D_A, no BF, write)     the master reading a byte and NACKing it
+//     stop (P)                     a stop, after the byte or NACK that
+//                                  came in the same interrupt
+//
+// A record with SSPOV is fed in the same way (the replay has its own
+// receive overflows, if the build has them).  The I2C records before the
+// first start or address of each dump are left out, as the ring had lost
+// the beginning of that transaction.  When the slave holds the clock, the
+// I2C records after it wait for it to let go, and every later one in the
+// same transaction is that much later than recorded; the next transaction
+// starts at its recorded time again.  A slave that holds the clock past
+// 10 ms is counted and let go of, as a master would time out.
+//
+// It prints what the slave did with the traffic, in the order it did it:
+//     write 9E: AB 01 05
+//     read  9F: 05 00 11 5A D2
+//     uart out: 01 41 ...
+//     to main() high: type 40, 3 bytes AB 01 05
+//     route 0: type 12, 5 bytes ...
+//     pin 2 -> 1
+// (the bytes of a read are the ones the slave sent back, with "NACK"
+// where the slave didn't answer, and the UART bytes out of the slave are
+// put on one line until the line goes quiet), and then a summary: the
+// records replayed, the messages to main() by type, the errors reported
+// (MSGT_I2C_DBG), how long the clock was held and how much later than
+// recorded that made the master, and what the I2C interrupts cost (the
+// flat -i charge, and the host CPU time the handler took).  With -t the
+// times and the host CPU times are left out, so two builds' transcripts
+// can be compared with diff.
+//
+// Build on the host with "make sim" in the directory above (see the
+// Makefile there), which builds the PICs with the --wrap flags this needs,
+// and run it as
+//     ./replay [-l PIC's shared object] [-d dir of the .so] [-i instruction
+//              cycles per interrupt] [-w instruction cycles per pass of
+//              main()] [-t] [-v] [dump file]
+// which replays the dumps in the file (or stdin, as capdecode reads them)
+// into SENSORPIC.so; -v also prints the records as they are fed in.
+// "make replay CAPTURE=file" runs it on the sensor PIC.
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "capture.h"
+#include "simsched.h"
+
+// as in messages.h and my_i2c.h
+#define MSGT_I2C_DBG 41
+#define I2C_ERR_OVERRUN 0x4
+#define NUM_ERRS 5
+
+static const char *err_names[NUM_ERRS] = {
+    "overrun", "no address", "no data", "too long", "truncated"
+};
+
+// SSPSTAT as it is kept in the tag (capdecode.c)
+#define SSP_D_A 0x20
+#define SSP_P 0x10
+#define SSP_S 0x08
+#define SSP_R_W 0x04
+#define SSP_BF 0x01
+
+// timer1 counts from Fosc/4 with a 1:8 prescale
+#define CAP_TICK (SIM_FOSC / 1500000)
+// the PIC boots before the first record, and the dumps are this far apart
+#define DUMP_GAP (SIM_FOSC / 10)
+#define HOLD_LIMIT (SIM_FOSC / 100)
+// how long the slave runs on after the last record
+#define TAIL (SIM_FOSC / 20)
+
+typedef struct rec {
+    sim_time t;
+    unsigned char tag;
+    unsigned char data;
+    // the first record of its dump
+    unsigned char first;
+} rec;
+
+static rec *recs;
+static int num_recs;
+static int no_times;
+
+static struct {
+    int dumps;
+    unsigned long overwritten;
+    unsigned long skipped;
+    unsigned long fed;
+    unsigned long uart;
+    unsigned long ferr;
+    unsigned long oerr;
+    unsigned long sspov;
+    unsigned long unknown;
+} run;
+
+// the bus as the records have left it
+static struct {
+    int synced;
+    int started;
+    // the transaction being printed
+    int in_trans;
+    int reading;
+    int nacked;
+    // the master has NACKed the last byte of the read
+    int read_done;
+    unsigned char addr;
+    unsigned char bytes[256];
+    unsigned char nack[256];
+    int len;
+    unsigned long writes;
+    unsigned long reads;
+    unsigned long bytes_written;
+    unsigned long bytes_read;
+    unsigned long nacks;
+} bus;
+
+// the clock held by the slave, and how far behind the recording the master
+// is because of it
+static struct {
+    int held;
+    unsigned gen;
+    // the record waiting for the clock
+    int waiting;
+    sim_time slip;
+    sim_time slip_max;
+    unsigned long late;
+    sim_time late_total;
+    unsigned long stuck;
+} clk;
+
+static struct {
+    unsigned long types[256];
+    unsigned long dropped;
+    unsigned long errors[NUM_ERRS];
+    unsigned long unknown;
+} msgs;
+
+static struct {
+    unsigned char buf[64];
+    int len;
+    unsigned gen;
+} uart_out;
+
+static void out(const char *fmt, ...) {
+    va_list ap;
+
+    if (!no_times) {
+        printf("%12.6f ms  ", MS(now - DUMP_GAP));
+    }
+    va_start(ap, fmt);
+    vprintf(fmt, ap);
+    va_end(ap);
+    printf("\n");
+}
+
+//----------------------------------------------------------------------------
+// Reading the dumps
+
+static void read_dumps(FILE *f) {
+    sim_time t = DUMP_GAP;
+    unsigned int last = 0;
+    unsigned char r[4];
+    int count, i, j, c;
+    int size = 0;
+
+    while ((c = getc(f)) != EOF) {
+        if (c != CAP_DUMP_MAGIC) {
+            continue;
+        }
+        if ((c = getc(f)) != CAP_FORMAT) {
+            // (not a header, unless this byte starts one)
+            if (c != EOF) {
+                ungetc(c, f);
+            }
+            continue;
+        }
+        if ((count = getc(f)) == EOF || (c = getc(f)) == EOF) {
+            break;
+        }
+        if (run.dumps++) {
+            t += DUMP_GAP;
+        }
+        run.overwritten += c;
+        for (i = 0; i < count; i++) {
+            for (j = 0; j < 4; j++) {
+                if ((c = getc(f)) == EOF) {
+                    fprintf(stderr, "replay: dump %d cut short after %d records\n", run.dumps,
+                            i);
+                    return;
+                }
+                r[j] = c;
+            }
+            if (num_recs == size) {
+                size = size ? 2 * size : 256;
+                if (!(recs = realloc(recs, size * sizeof (rec)))) {
+                    fprintf(stderr, "replay: out of memory\n");
+                    exit(1);
+                }
+            }
+            // (assuming less than one timer1 wrap between records)
+            if (i > 0) {
+                t += (sim_time) (((r[2] | (r[3] << 8)) - last) & 0xFFFF) * CAP_TICK;
+            }
+            last = r[2] | (r[3] << 8);
+            recs[num_recs].t = t;
+            recs[num_recs].tag = r[0];
+            recs[num_recs].data = r[1];
+            recs[num_recs].first = (i == 0);
+            num_recs++;
+        }
+    }
+}
+
+//----------------------------------------------------------------------------
+// The I2C records
+
+static void trans_end(void) {
+    char line[8 * 256 + 16];
+    int n = 0;
+    int i;
+
+    if (!bus.in_trans) {
+        return;
+    }
+    n += sprintf(line + n, "%s %02X:", bus.reading ? "read " : "write", bus.addr);
+    if (bus.nacked && !bus.len) {
+        n += sprintf(line + n, " NACK");
+    }
+    for (i = 0; i < bus.len; i++) {
+        n += sprintf(line + n, " %02X%s", bus.bytes[i], bus.nack[i] ? " NACK" : "");
+    }
+    out("%s", line);
+    bus.in_trans = 0;
+}
+
+static void add_byte(unsigned char data, int nacked) {
+    if (bus.len < (int) sizeof (bus.bytes)) {
+        bus.bytes[bus.len] = data;
+        bus.nack[bus.len] = nacked;
+        bus.len++;
+    }
+    if (bus.reading) {
+        bus.bytes_read++;
+    } else {
+        bus.bytes_written++;
+    }
+}
+
+static void ev_hold_limit(int unused, int unused2, unsigned gen);
+
+static void hold(int flags) {
+    if (flags & SIM_I2C_HOLD) {
+        clk.held = 1;
+        clk.gen++;
+        nodes[0].hold_from = now;
+        nodes[0].holds++;
+        push(now + HOLD_LIMIT, ev_hold_limit, 0, 0, clk.gen);
+    }
+}
+
+static void start(void) {
+    trans_end();
+    nodes[0].pic->i2c_start();
+    bus.started = 1;
+}
+
+static void address(unsigned char data) {
+    int flags;
+
+    if (!bus.started) {
+        start();
+    }
+    trans_end();
+    bus.started = 0;
+    bus.in_trans = 1;
+    bus.addr = data;
+    bus.reading = data & 1;
+    bus.read_done = 0;
+    bus.len = 0;
+    flags = nodes[0].pic->i2c_address(data);
+    bus.nacked = !(flags & SIM_I2C_ACKED);
+    if (bus.reading) {
+        bus.reads++;
+    } else {
+        bus.writes++;
+    }
+    bus.nacks += bus.nacked;
+    hold(flags);
+}
+
+static void write_byte(unsigned char data) {
+    int flags = nodes[0].pic->i2c_write(data);
+
+    add_byte(data, !(flags & SIM_I2C_ACKED));
+    bus.nacks += !(flags & SIM_I2C_ACKED);
+    hold(flags);
+}
+
+static void read_byte(int nack) {
+    unsigned char data = nodes[0].pic->i2c_read();
+
+    add_byte(data, 0);
+    bus.read_done = nack;
+    hold(nodes[0].pic->i2c_ack(nack));
+}
+
+static void i2c_record(unsigned char tag, unsigned char data) {
+    int stop = tag & SSP_P;
+
+    if (tag & CAP_I2C_SSPOV) {
+        run.sspov++;
+    }
+    if (!bus.synced) {
+        // (the ring had lost the start of this transaction)
+        if (stop || (tag & SSP_D_A) || !((tag & SSP_BF) || (tag & SSP_S))) {
+            run.skipped++;
+            bus.synced = stop;
+            return;
+        }
+        bus.synced = 1;
+    }
+    if (!(tag & SSP_D_A)) {
+        if (tag & SSP_BF) {
+            address(data);
+        } else if (tag & SSP_S) {
+            start();
+        } else if (!stop) {
+            run.unknown++;
+        }
+    } else if (tag & SSP_BF) {
+        write_byte(data);
+    } else if (!bus.in_trans || !bus.reading || bus.read_done) {
+        // (D_A stays set from the last byte for a stop on its own)
+        if (!stop) {
+            run.unknown++;
+        }
+    } else if (tag & SSP_R_W) {
+        if (!stop) {
+            read_byte(0);
+        }
+    } else {
+        // the master's NACK of the last byte of a read (and then its stop
+        // too, if they came in one interrupt)
+        read_byte(1);
+    }
+    if (stop) {
+        trans_end();
+        nodes[0].pic->i2c_stop();
+        bus.started = 0;
+    }
+}
+
+static int next_i2c(int i) {
+    for (i++; (i < num_recs) && (recs[i].tag & CAP_UART); i++) {
+    }
+    return (i);
+}
+
+static void ev_i2c(int i, int unused, unsigned unused2);
+
+static void feed_i2c(int i) {
+    sim_time t;
+    int j;
+
+    if (recs[i].first) {
+        // a new dump: whatever was on the bus is gone
+        trans_end();
+        if (bus.started || bus.in_trans) {
+            nodes[0].pic->i2c_stop();
+        }
+        bus.started = 0;
+        bus.synced = 0;
+        clk.slip = 0;
+    }
+    if (verbose) {
+        trace("i2c  %02X  tag %02X", recs[i].data, recs[i].tag);
+    }
+    i2c_record(recs[i].tag, recs[i].data);
+    run.fed++;
+    if ((j = next_i2c(i)) >= num_recs) {
+        return;
+    }
+    // a transaction's records keep the slip, the next one starts on time
+    if (bus.in_trans || bus.started) {
+        t = recs[j].t + clk.slip;
+    } else {
+        clk.slip = 0;
+        t = (recs[j].t > now) ? recs[j].t : now;
+    }
+    push(t, ev_i2c, j, 0, 0);
+    if (t + TAIL > end) {
+        end = t + TAIL;
+    }
+}
+
+static void ev_i2c(int i, int unused, unsigned unused2) {
+    (void) unused;
+    (void) unused2;
+    if (clk.held) {
+        clk.waiting = i;
+        return;
+    }
+    feed_i2c(i);
+}
+
+// the clock let go (or given up on): the record waiting for it goes now,
+// that much later than it would have
+
+static void let_go(void) {
+    sim_time length = now - nodes[0].hold_from;
+    sim_time late;
+    int i = clk.waiting;
+
+    clk.held = 0;
+    nodes[0].held += length;
+    if (length > nodes[0].held_max) {
+        nodes[0].held_max = length;
+    }
+    if (i < 0) {
+        return;
+    }
+    clk.waiting = -1;
+    late = now - (recs[i].t + clk.slip);
+    if (late > 0) {
+        clk.late++;
+        clk.late_total += late;
+        clk.slip += late;
+        if (clk.slip > clk.slip_max) {
+            clk.slip_max = clk.slip;
+        }
+    }
+    feed_i2c(i);
+}
+
+static void ev_hold_limit(int unused, int unused2, unsigned gen) {
+    (void) unused;
+    (void) unused2;
+    if (clk.held && (gen == clk.gen)) {
+        trace("the clock has been held for %.3f ms", MS(HOLD_LIMIT));
+        clk.stuck++;
+        let_go();
+    }
+}
+
+static void ev_release(int unused, int unused2, unsigned unused3) {
+    (void) unused;
+    (void) unused2;
+    (void) unused3;
+    if (clk.held) {
+        let_go();
+    }
+}
+
+//----------------------------------------------------------------------------
+// The UART records, and the rest of the PIC's world
+
+static void ev_uart_rec(int i, int unused, unsigned unused2) {
+    unsigned char errs = recs[i].tag & CAP_UART_ERRS;
+
+    (void) unused;
+    (void) unused2;
+    if (verbose) {
+        trace("uart %02X%s%s", recs[i].data, (errs & SIM_UART_FERR) ? " FERR" : "",
+                (errs & SIM_UART_OERR) ? " OERR" : "");
+    }
+    run.uart++;
+    run.ferr += (errs & SIM_UART_FERR) != 0;
+    run.oerr += (errs & SIM_UART_OERR) != 0;
+    nodes[0].pic->uart_rx(recs[i].data, errs);
+}
+
+static void host_i2c_op(int n, int op, unsigned char data) {
+    (void) n;
+    (void) op;
+    (void) data;
+}
+
+static void host_i2c_release(int n) {
+    push(now, ev_release, n, 0, 0);
+}
+
+static void ev_uart_flush(int unused, int unused2, unsigned gen) {
+    char line[3 * sizeof (uart_out.buf) + 1];
+    int i;
+
+    (void) unused;
+    (void) unused2;
+    if ((gen != uart_out.gen) || !uart_out.len) {
+        return;
+    }
+    for (i = 0; i < uart_out.len; i++) {
+        sprintf(line + 3 * i, " %02X", uart_out.buf[i]);
+    }
+    out("uart out:%s", line);
+    uart_out.len = 0;
+}
+
+static void ev_uart(int n, int unused, unsigned unused2) {
+    (void) unused;
+    (void) unused2;
+    nodes[n].pic->event(SIM_EV_TXDONE, 0);
+}
+
+static void host_uart_tx(int n, unsigned char data, sim_time bit) {
+    if (uart_out.len == (int) sizeof (uart_out.buf)) {
+        ev_uart_flush(0, 0, uart_out.gen);
+    }
+    uart_out.buf[uart_out.len++] = data;
+    // (one line until the line has been idle for two bytes)
+    push(now + 30 * bit, ev_uart_flush, 0, 0, ++uart_out.gen);
+    push(now + 10 * bit, ev_uart, n, 0, 0);
+}
+
+static void host_pin(int n, int pin, int level) {
+    (void) n;
+    out("pin %d -> %d", pin, level);
+}
+
+static void host_message(int n, int queue, int sent, unsigned char msgtype,
+        unsigned char length, const unsigned char *data) {
+    char line[3 * 256 + 1];
+    int i;
+
+    (void) n;
+    for (i = 0; i < length; i++) {
+        sprintf(line + 3 * i, " %02X", data[i]);
+    }
+    line[3 * i] = 0;
+    if (queue >= SIM_MSG_ROUTE) {
+        out("route %d: type %d, %d bytes%s%s", queue - SIM_MSG_ROUTE, msgtype, length, line,
+                sent ? "" : " (dropped)");
+    } else {
+        out("to main() %s: type %d, %d bytes%s%s",
+                (queue == SIM_MSG_TO_MAIN_HIGH) ? "high" : "low", msgtype, length, line,
+                sent ? "" : " (dropped)");
+    }
+    msgs.types[msgtype]++;
+    if (!sent) {
+        msgs.dropped++;
+    }
+    if (msgtype == MSGT_I2C_DBG) {
+        // the count, the code and the event count (i2c_slave_errors())
+        if ((length >= 2) && (data[1] >= I2C_ERR_OVERRUN)
+                && (data[1] < I2C_ERR_OVERRUN + NUM_ERRS)) {
+            msgs.errors[data[1] - I2C_ERR_OVERRUN] += data[0];
+        } else {
+            msgs.unknown++;
+        }
+    }
+}
+
+static sim_host host = {
+    host_now,
+    host_wait,
+    host_at,
+    host_i2c_op,
+    host_i2c_release,
+    host_uart_tx,
+    host_pin,
+    150,
+    200,
+    host_message
+};
+
+//----------------------------------------------------------------------------
+
+static double host_seconds(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (ts.tv_sec + ts.tv_nsec / 1e9);
+}
+
+static void report(const char *lib, double host_time) {
+    sim_pic_stats s;
+    unsigned long errors = 0;
+    int k;
+
+    nodes[0].pic->stats(&s);
+    printf("\n%s: %d records from %d dump%s (%lu overwritten before them), %lu I2C and "
+            "%lu UART fed in, %lu I2C left out before a start\n", lib, num_recs, run.dumps,
+            (run.dumps == 1) ? "" : "s", run.overwritten, run.fed, run.uart, run.skipped);
+    if (run.unknown) {
+        printf("    (and %lu I2C records with no start, stop or data)\n", run.unknown);
+    }
+    printf("%lu writes and %lu reads, %lu bytes written and %lu read, %lu NACKs\n",
+            bus.writes, bus.reads, bus.bytes_written, bus.bytes_read, bus.nacks);
+    printf("recorded: SSPOV %lu, FERR %lu, OERR %lu; in the replay: SSPOV %lu, OERR %lu\n",
+            run.sspov, run.ferr, run.oerr, s.sspov, s.rx_overruns);
+    printf("the clock held %lu times", nodes[0].holds);
+    if (!no_times) {
+        printf(", %.3f ms in all, %.1f us at most", MS(nodes[0].held), US(nodes[0].held_max));
+    }
+    printf("; %lu times past %.0f ms\n", clk.stuck, MS(HOLD_LIMIT));
+    printf("the master later than recorded %lu times", clk.late);
+    if (!no_times) {
+        printf(", %.3f ms in all, %.1f us behind at most", MS(clk.late_total),
+                US(clk.slip_max));
+    }
+    printf("\n");
+    printf("interrupts: %lu high, %lu low, %lu for SSPIF; %.1f Tcy charged per I2C event "
+            "(-i)\n", s.isr_high, s.isr_low, s.ssp_isrs,
+            s.ssp_isrs ? (double) s.isr_time / SIM_TCY / s.ssp_isrs : 0.0);
+    if (!no_times) {
+        printf("    host CPU ns per SSPIF p50 %lu, p90 %lu, p99 %lu; %.3f s on the host\n",
+                ns_percentile(&s, 50), ns_percentile(&s, 90), ns_percentile(&s, 99),
+                host_time);
+    }
+    printf("\nto main() and the routes, by type:");
+    for (k = 0; k < 256; k++) {
+        if (msgs.types[k]) {
+            printf(" %d: %lu", k, msgs.types[k]);
+        }
+    }
+    printf("; %lu dropped\n", msgs.dropped);
+    for (k = 0; k < NUM_ERRS; k++) {
+        errors += msgs.errors[k];
+    }
+    printf("errors reported: %lu\n", errors);
+    for (k = 0; k < NUM_ERRS; k++) {
+        printf("    %02X %-10s %9lu\n", I2C_ERR_OVERRUN + k, err_names[k], msgs.errors[k]);
+    }
+    if (msgs.unknown) {
+        printf("    (and %lu MSGT_I2C_DBG with no known code)\n", msgs.unknown);
+    }
+    if (s.pool_empty) {
+        printf("sends that found the message pool empty: %lu\n", s.pool_empty);
+    }
+}
+
+static void usage(void) {
+    fprintf(stderr, "usage: replay [-l lib] [-d dir] [-i cycles per interrupt] "
+            "[-w cycles per pass of main()] [-t] [-v] [dump file]\n");
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    const char *dir = ".";
+    const char *lib = "SENSORPIC.so";
+    FILE *f = stdin;
+    double host_time;
+    int opt, i;
+
+    while ((opt = getopt(argc, argv, "l:d:i:w:tv")) != -1) {
+        switch (opt) {
+            case 'l': lib = optarg; break;
+            case 'd': dir = optarg; break;
+            case 'i': host.isr_tcy = strtoul(optarg, 0, 0); break;
+            case 'w': host.main_tcy = strtoul(optarg, 0, 0); break;
+            case 't': no_times = 1; break;
+            case 'v': verbose = 1; break;
+            default: usage();
+        }
+    }
+    if ((optind < argc - 1) || !host.isr_tcy) {
+        usage();
+    }
+    if ((optind < argc) && !(f = fopen(argv[optind], "rb"))) {
+        perror(argv[optind]);
+        exit(1);
+    }
+    read_dumps(f);
+    if (!num_recs) {
+        fprintf(stderr, "replay: no dump found\n");
+        exit(1);
+    }
+    clk.waiting = -1;
+    end = recs[num_recs - 1].t + TAIL;
+
+    sched_node("replay", dir, "slave", lib, &host);
+    sched_start();
+    for (i = 0; i < num_recs; i++) {
+        if (recs[i].tag & CAP_UART) {
+            push(recs[i].t, ev_uart_rec, i, 0, 0);
+        }
+    }
+    if ((i = next_i2c(-1)) < num_recs) {
+        push(recs[i].t, ev_i2c, i, 0, 0);
+    }
+
+    host_time = host_seconds();
+    sched_run();
+    host_time = host_seconds() - host_time;
+    trans_end();
+    ev_uart_flush(0, 0, uart_out.gen);
+    report(lib, host_time);
+    // (the PIC is left waiting for the CPU)
+    exit(clk.stuck ? 1 : 0);
+}
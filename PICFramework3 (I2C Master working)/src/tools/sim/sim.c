@@ -0,0 +1,1101 @@
+// Runs the sensor, motor and master firmware together on the host, each
+// PIC in its own thread, joined by a simulated I2C bus and UART links, with
+// stand-ins for what is on the other end of those:
+//
+//     IR sensor board -- UART --> SENSORPIC (0x9E) --+
+//                                                    |-- I2C -- I2CMASTER -- UART --> PC
+//     motor controller <-- UART -- MOTORPIC (0xBE) --+              |
+//                                                    +-- I2C -- ARM (a stand-in master)
+//
+// and the data-ready line from the sensor PIC to the master (dready.h).
+// The IR board sends a numbered five byte frame every so often; the master
+// reads each one from the sensor PIC when the line goes up and forwards it
+// to the PC, which checks that every frame arrives, once and in order, and
+// times it from the IR board to the PC.  The ARM stand-in writes a
+// numbered movement command (0xBA) to the motor PIC every so often and
+// reads the ack, and the motor controller checks that the commands that
+// were acked arrive in order.  At the end the throughput, the losses and
+// where the time went are printed for the bus and for each PIC.
+//
+// The bus runs at the rate each master's SSPADD gives it (the ARM is at
+// 100 kHz), and every byte takes its nine clocks.  A slave that holds the
+// clock low after a byte (pic.c) holds up the master's next operation until
+// its firmware sets CKP.  Two masters that start within half a bit of each
+// other keep in step (one that has not loaded its next byte holds the
+// clock) and arbitrate bit by bit on what they write, and the one that
+// sends a 1 where the other sends a 0 loses at that bit; one that starts
+// while the bus is busy loses at once.  The ARM stand-in waits for a stop before it
+// starts, as a multi-master should; the firmware master does not.  A PIC
+// that loses gets BCLIF.
+//
+// Only one thread ever runs at a time: the scheduler hands the CPU to a
+// PIC and gets it back when that PIC's simulated time has to stop (see
+// pic.c), so a run is the same every time.  Simulated time is in cycles of
+// the PICs' 48 MHz oscillator.
+//
+// Build on the host (gcc or clang, Linux) with "make sim" in the directory
+// above (see the Makefile there), or from this directory with
+//     for role in SENSORPIC MOTORPIC I2CMASTER; do
+//         cc -shared -fPIC -fcommon -fvisibility=hidden -Wall -Wextra
+//             -Wno-unused-parameter -Wno-unknown-pragmas -Iinclude -I.
+//             -D__18F46J50 -D$role -DDATA_READY -o $role.so pic.c ../../src/*.c
+//     done
+//     cc -O2 -Wall -pthread -I../../src -o sim sim.c simsched.c -ldl
+// (add -D flags from maindefs.h to all three, or to one, to try features
+// with the rest of the system) and run it as
+//     ./sim [-t seconds] [-f ms between IR frames] [-m ms between motor
+//           commands, 0 for none] [-i instruction cycles per interrupt]
+//           [-w instruction cycles per pass of main()] [-d dir of the .so] [-b] [-v]
+// which by default runs 10 s with a frame every 20 ms and a command every
+// 50 ms; -v prints every bus operation, and -b prints only a line for each
+// path, to compare builds and rates with ("make bench" runs a few).  (The -Wno flags are for C18's
+// #pragmas, and for the handler arguments that not every handler uses.)
+//
+// The firmware itself takes no time: each interrupt and each pass of
+// main() is charged the flat cost given by -i and -w, which are guesses
+// and not measurements, so the CPU figures are only as good as those.
+// What the handlers do is only measured in the host CPU time they take
+// (the last table of the report), which is good for comparing builds over
+// a few runs each, in the tail of the SSPIF times more than in the means:
+// from one run to the next the means move by more than most changes do.
+// A high priority interrupt does not break into a low priority one, and
+// main() gets nothing done between two interrupts that follow each other
+// (the PIC gets one instruction in).  Neither TICKLESS_IDLE nor CLOCK_GOVERNOR
+// can be simulated: main() sets GIEH again after its own SLEEP, and the
+// simulator cannot see that happen.  Nor can anything that needs the
+// A/D converter, or a different oscillator.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "simsched.h"
+#include "motor_cmd.h"
+#include "dready.h"
+
+// the PICs, in the order they are loaded
+#define NODE_SENSOR 0
+#define NODE_MOTOR 1
+#define NODE_MASTER 2
+#define NUM_NODES 3
+
+// as in maindefs.h
+#define SENSOR_ADDR 0x9E
+#define MOTOR_ADDR 0xBE
+// RB3 (dready.h)
+#define DREADY_PIN (DREADY_RP - 3)
+// the stand-ins' frames
+#define IR_FRAMELEN 5
+#define ARM_HALF_BIT (SIM_FOSC / 200000)
+
+// latencies, kept for their percentiles
+typedef struct samples {
+    sim_time *v;
+    unsigned long n;
+    unsigned long size;
+    int sorted;
+} samples;
+
+static void sample(samples *s, sim_time t) {
+    if (s->n == s->size) {
+        s->size = s->size ? 2 * s->size : 1024;
+        s->v = realloc(s->v, s->size * sizeof (sim_time));
+        if (!s->v) {
+            perror("sim");
+            exit(1);
+        }
+    }
+    s->v[s->n++] = t;
+    s->sorted = 0;
+}
+
+static int by_time(const void *x, const void *y) {
+    sim_time a = *(const sim_time *) x;
+    sim_time b = *(const sim_time *) y;
+
+    return ((a > b) - (a < b));
+}
+
+// the smallest sample that at least p percent of them are no larger than
+
+static sim_time percentile(samples *s, int p) {
+    unsigned long i;
+
+    if (s->n == 0) {
+        return (0);
+    }
+    if (!s->sorted) {
+        qsort(s->v, s->n, sizeof (sim_time), by_time);
+        s->sorted = 1;
+    }
+    i = (s->n * p + 99) / 100;
+    return (s->v[(i > 0) ? i - 1 : 0]);
+}
+
+//----------------------------------------------------------------------------
+// The I2C bus
+
+static const char *op_names[] = {"START", "RESTART", "WRITE", "READ", "ACK", "STOP"};
+
+#define MASTER_PIC 0
+#define MASTER_ARM 1
+#define NUM_MASTERS 2
+
+typedef struct master {
+    const char *name;
+    // the PIC it is, or -1 for the stand-in
+    int node;
+    // the operation it wants, or -1, and when it asked
+    int op;
+    unsigned char data;
+    sim_time asked;
+    // started, and has not lost
+    int contending;
+    unsigned long starts;
+    unsigned long lost;
+} master;
+
+static master masters[NUM_MASTERS] = {
+    {"master", NODE_MASTER, -1},
+    {"ARM", -1, -1}
+};
+
+#define BUS_IDLE 0
+#define BUS_STARTING 1
+#define BUS_BUSY 2
+
+static struct {
+    int state;
+    sim_time start_at;
+    master *first;
+    // the operation on the bus, and who it is for
+    int op_busy;
+    int op;
+    master *driver;
+    unsigned char read_data;
+    // nodes holding the clock low
+    unsigned held;
+    int addr_next;
+    int slave;
+    int reading;
+    unsigned long transactions;
+    unsigned long nacks;
+    sim_time busy;
+    sim_time stalled;
+    sim_time stall_from;
+} bus;
+
+static void arm_done(int, int, unsigned char);
+static void arm_lost(void);
+static void arm_bus_idle(void);
+static void gather_read(unsigned char);
+static void gather_end(void);
+
+static sim_time half_bit(master *m) {
+    return ((m->node >= 0) ? nodes[m->node].pic->i2c_half_bit() : ARM_HALF_BIT);
+}
+
+static void done(master *m, int op, int acked, unsigned char data) {
+    m->op = -1;
+    if (m->node >= 0) {
+        nodes[m->node].pic->i2c_done(op, acked, data);
+    } else {
+        arm_done(op, acked, data);
+    }
+}
+
+static void lose(master *m) {
+    trace("%s loses the bus", m->name);
+    m->contending = 0;
+    m->op = -1;
+    m->lost++;
+    if (m->node >= 0) {
+        nodes[m->node].pic->i2c_lost();
+    } else {
+        arm_lost();
+    }
+}
+
+static void ev_lose(int i, int unused, unsigned unused2) {
+    (void) unused;
+    (void) unused2;
+    lose(&masters[i]);
+}
+
+static int contenders(void) {
+    int i;
+    int count = 0;
+
+    for (i = 0; i < NUM_MASTERS; i++) {
+        count += masters[i].contending;
+    }
+    return (count);
+}
+
+static void hold(int n) {
+    bus.held |= 1 << n;
+    nodes[n].hold_from = now;
+    nodes[n].holds++;
+}
+
+static void ev_op_end(int, int, unsigned);
+
+// Of masters that started together, those that want to do something else
+// than m lose at once, and of those writing, the ones sending a 1 lose at
+// the first bit where another sends a 0 -- so the lowest byte wins
+
+static master *arbitrate(master *m) {
+    master *winner = m;
+    unsigned char diff;
+    int bit;
+    int i;
+
+    for (i = 0; i < NUM_MASTERS; i++) {
+        if (masters[i].contending && (masters[i].op != m->op)) {
+            lose(&masters[i]);
+        } else if (masters[i].contending && (masters[i].data < winner->data)) {
+            winner = &masters[i];
+        }
+    }
+    if (m->op != SIM_I2C_WRITE) {
+        return (m);
+    }
+    for (i = 0; i < NUM_MASTERS; i++) {
+        if (masters[i].contending && (masters[i].data != winner->data)) {
+            diff = masters[i].data ^ winner->data;
+            for (bit = 0; !(diff & (0x80 >> bit)); bit++) {
+            }
+            masters[i].contending = 0;
+            push(now + (bit + 1) * 2 * half_bit(&masters[i]), ev_lose, i, 0, 0);
+        }
+    }
+    return (winner);
+}
+
+// starts the next operation, once the last is over and no slave holds
+// the clock
+
+static void bus_next(void) {
+    master *m = 0;
+    sim_time h;
+    sim_time length = 0;
+    int i;
+
+    if ((bus.state != BUS_BUSY) || bus.op_busy) {
+        return;
+    }
+    for (i = 0; i < NUM_MASTERS; i++) {
+        if (masters[i].contending && (masters[i].op >= 0)
+                && (!m || (masters[i].asked < m->asked))) {
+            m = &masters[i];
+        }
+    }
+    if (!m) {
+        return;
+    }
+    if (contenders() > 1) {
+        // a master that has not loaded its next byte holds the clock low,
+        // and the others wait for it
+        for (i = 0; i < NUM_MASTERS; i++) {
+            if (masters[i].contending && (masters[i].op < 0)) {
+                return;
+            }
+        }
+    }
+    if (bus.held) {
+        if (!bus.stall_from) {
+            bus.stall_from = now;
+        }
+        return;
+    }
+    if (bus.stall_from) {
+        bus.stalled += now - bus.stall_from;
+        bus.stall_from = 0;
+    }
+    if (contenders() > 1) {
+        m = arbitrate(m);
+    }
+    h = half_bit(m);
+    switch (m->op) {
+        case SIM_I2C_RESTART:
+            length = 3 * h;
+            break;
+        case SIM_I2C_WRITE:
+            length = 18 * h;
+            break;
+        case SIM_I2C_READ:
+            length = 16 * h;
+            bus.read_data = 0xFF;
+            if ((bus.slave >= 0) && bus.reading) {
+                bus.read_data = nodes[bus.slave].pic->i2c_read();
+            }
+            break;
+        case SIM_I2C_ACK:
+        case SIM_I2C_STOP:
+            length = 2 * h;
+            break;
+    }
+    bus.op_busy = 1;
+    bus.op = m->op;
+    bus.driver = m;
+    bus.busy += length;
+    push(now + length, ev_op_end, m - masters, 0, 0);
+}
+
+static void slaves_start(void) {
+    int n;
+
+    gather_end();
+    bus.addr_next = 1;
+    bus.slave = -1;
+    for (n = 0; n < NUM_NODES; n++) {
+        nodes[n].pic->i2c_start();
+    }
+}
+
+static int bus_write(unsigned char data) {
+    int flags;
+    int n;
+
+    if (bus.addr_next) {
+        bus.addr_next = 0;
+        bus.reading = data & 1;
+        for (n = 0; n < NUM_NODES; n++) {
+            flags = nodes[n].pic->i2c_address(data);
+            if (flags & SIM_I2C_HOLD) {
+                hold(n);
+            }
+            if ((flags & SIM_I2C_ACKED) && (bus.slave < 0)) {
+                bus.slave = n;
+            }
+        }
+        return (bus.slave >= 0);
+    }
+    if ((bus.slave < 0) || bus.reading) {
+        return (0);
+    }
+    flags = nodes[bus.slave].pic->i2c_write(data);
+    if (flags & SIM_I2C_HOLD) {
+        hold(bus.slave);
+    }
+    return (flags & SIM_I2C_ACKED);
+}
+
+static void ev_start_done(int unused, int unused2, unsigned unused3) {
+    int i;
+
+    (void) unused;
+    (void) unused2;
+    (void) unused3;
+    bus.state = BUS_BUSY;
+    bus.transactions++;
+    bus.busy += now - bus.start_at;
+    slaves_start();
+    for (i = 0; i < NUM_MASTERS; i++) {
+        if (masters[i].contending) {
+            trace("%s START", masters[i].name);
+            masters[i].starts++;
+            done(&masters[i], SIM_I2C_START, 1, 0);
+        }
+    }
+    bus_next();
+}
+
+static void ev_op_end(int unused, int unused2, unsigned unused3) {
+    int op = bus.op;
+    unsigned char data = bus.driver->data;
+    int acked = 1;
+    int flags;
+    int i;
+    int n;
+
+    (void) unused;
+    (void) unused2;
+    (void) unused3;
+    switch (op) {
+        case SIM_I2C_RESTART:
+            slaves_start();
+            break;
+        case SIM_I2C_WRITE:
+            acked = bus_write(data);
+            if (!acked) {
+                bus.nacks++;
+            }
+            break;
+        case SIM_I2C_READ:
+            data = bus.read_data;
+            if ((bus.slave == NODE_SENSOR) && bus.reading) {
+                gather_read(data);
+            }
+            break;
+        case SIM_I2C_ACK:
+            if ((bus.slave >= 0) && bus.reading) {
+                flags = nodes[bus.slave].pic->i2c_ack(data);
+                if (flags & SIM_I2C_HOLD) {
+                    hold(bus.slave);
+                }
+            }
+            break;
+        case SIM_I2C_STOP:
+            gather_end();
+            bus.state = BUS_IDLE;
+            for (n = 0; n < NUM_NODES; n++) {
+                nodes[n].pic->i2c_stop();
+            }
+            break;
+    }
+    trace("%s %s %02X%s", bus.driver->name, op_names[op], data,
+            (op == SIM_I2C_WRITE) ? (acked ? " ACK" : " NACK") : "");
+    bus.op_busy = 0;
+    for (i = 0; i < NUM_MASTERS; i++) {
+        if (masters[i].contending && (masters[i].op == op)) {
+            if (op == SIM_I2C_STOP) {
+                masters[i].contending = 0;
+            }
+            done(&masters[i], op, acked, data);
+        }
+    }
+    if (op == SIM_I2C_STOP) {
+        arm_bus_idle();
+    }
+    bus_next();
+}
+
+static void ev_bus_request(int i, int unused, unsigned unused2) {
+    master *m = &masters[i];
+
+    (void) unused;
+    (void) unused2;
+    if ((m->op != SIM_I2C_START) && !m->contending) {
+        lose(m);
+        return;
+    }
+    if (m->op != SIM_I2C_START) {
+        bus_next();
+        return;
+    }
+    if (bus.state == BUS_IDLE) {
+        bus.state = BUS_STARTING;
+        bus.start_at = now;
+        bus.first = m;
+        m->contending = 1;
+        push(now + 2 * half_bit(m), ev_start_done, 0, 0, 0);
+    } else if ((bus.state == BUS_STARTING) && (now < bus.start_at + half_bit(bus.first))) {
+        // SDA has not gone low yet, so this is a start too
+        m->contending = 1;
+    } else {
+        // SDA or SCL is low
+        lose(m);
+    }
+}
+
+static void ask(master *m, int op, unsigned char data) {
+    m->op = op;
+    m->data = data;
+    m->asked = now;
+    push(now, ev_bus_request, m - masters, 0, 0);
+}
+
+static void host_i2c_op(int n, int op, unsigned char data) {
+    (void) n;
+    ask(&masters[MASTER_PIC], op, data);
+}
+
+static void ev_release(int n, int unused, unsigned unused2) {
+    sim_time length = now - nodes[n].hold_from;
+
+    (void) unused;
+    (void) unused2;
+    if (bus.held & (1 << n)) {
+        bus.held &= ~(1 << n);
+        nodes[n].held += length;
+        if (length > nodes[n].held_max) {
+            nodes[n].held_max = length;
+        }
+        bus_next();
+    }
+}
+
+static void host_i2c_release(int n) {
+    push(now, ev_release, n, 0, 0);
+}
+
+//----------------------------------------------------------------------------
+// The ARM stand-in: writes a movement command to the motor PIC and reads
+// its ack, over and over
+
+#define ARM_STEPS 17
+#define ARM_STOP 16
+#define FIFO_LEN 256
+
+static struct {
+    sim_time period;
+    int active;
+    int step;
+    int failed;
+    int wait_idle;
+    unsigned char seq;
+    unsigned char cmd[MOTOR_CMDLEN + 1];
+    unsigned char reply[3];
+    int num_reply;
+    unsigned long commands;
+    unsigned long ok;
+    unsigned long full;
+    unsigned long nacked;
+    unsigned long skipped;
+    unsigned char depth_max;
+    // when the last byte of the command was ACKed
+    sim_time written_at;
+    // the commands acked, and when they were written, for the motor
+    // controller to check off
+    unsigned char acked[FIFO_LEN];
+    sim_time acked_at[FIFO_LEN];
+    int head;
+    int tail;
+} arm;
+
+static void ev_arm_step(int unused, int unused2, unsigned unused3) {
+    master *m = &masters[MASTER_ARM];
+    int s = arm.step;
+
+    (void) unused;
+    (void) unused2;
+    (void) unused3;
+    if (s == 0) {
+        if (bus.state == BUS_BUSY) {
+            arm.wait_idle = 1;
+            return;
+        }
+        ask(m, SIM_I2C_START, 0);
+    } else if (s == 1) {
+        ask(m, SIM_I2C_WRITE, MOTOR_ADDR);
+    } else if (s < 2 + MOTOR_CMDLEN + 1) {
+        ask(m, SIM_I2C_WRITE, arm.cmd[s - 2]);
+    } else if (s == 8) {
+        ask(m, SIM_I2C_RESTART, 0);
+    } else if (s == 9) {
+        ask(m, SIM_I2C_WRITE, MOTOR_ADDR | 1);
+    } else if (s < ARM_STOP) {
+        // read, ACK, read, ACK, read, NACK
+        if (s & 1) {
+            ask(m, SIM_I2C_ACK, s == ARM_STOP - 1);
+        } else {
+            ask(m, SIM_I2C_READ, 0);
+        }
+    } else {
+        ask(m, SIM_I2C_STOP, 0);
+    }
+}
+
+static void arm_begin(void) {
+    arm.step = 0;
+    arm.num_reply = 0;
+    arm.failed = 0;
+    ev_arm_step(0, 0, 0);
+}
+
+static void ev_arm_tick(int unused, int unused2, unsigned unused3) {
+    (void) unused;
+    (void) unused2;
+    (void) unused3;
+    push(now + arm.period, ev_arm_tick, 0, 0, 0);
+    if (arm.active) {
+        arm.skipped++;
+        return;
+    }
+    arm.active = 1;
+    arm.commands++;
+    arm.cmd[0] = 0xBA;
+    arm.cmd[1] = arm.seq;
+    arm.cmd[2] = ~arm.seq;
+    arm.cmd[3] = 0x11;
+    arm.cmd[4] = 0x22;
+    arm.cmd[5] = arm.seq;
+    arm_begin();
+}
+
+static void arm_done(int op, int acked, unsigned char data) {
+    if ((op == SIM_I2C_WRITE) && !acked) {
+        arm.nacked++;
+        arm.failed = 1;
+        arm.step = ARM_STOP;
+    } else if (op == SIM_I2C_STOP) {
+        arm.active = 0;
+        if (!arm.failed) {
+            if (arm.reply[0] == MOTOR_ACK_OK) {
+                arm.ok++;
+                arm.acked[arm.tail] = arm.seq;
+                arm.acked_at[arm.tail] = arm.written_at;
+                arm.tail = (arm.tail + 1) % FIFO_LEN;
+            } else {
+                arm.full++;
+            }
+            if (arm.reply[2] > arm.depth_max) {
+                arm.depth_max = arm.reply[2];
+            }
+        }
+        arm.seq++;
+        return;
+    } else {
+        if ((op == SIM_I2C_WRITE) && (arm.step == 1 + MOTOR_CMDLEN + 1)) {
+            arm.written_at = now;
+        }
+        if ((op == SIM_I2C_READ) && (arm.num_reply < 3)) {
+            arm.reply[arm.num_reply++] = data;
+        }
+        arm.step++;
+    }
+    push(now, ev_arm_step, 0, 0, 0);
+}
+
+// start again from the top once the bus is free
+
+static void arm_lost(void) {
+    arm.wait_idle = 1;
+    if (bus.state == BUS_IDLE) {
+        arm_bus_idle();
+    }
+}
+
+static void arm_bus_idle(void) {
+    if (arm.wait_idle) {
+        arm.wait_idle = 0;
+        arm.step = 0;
+        arm.num_reply = 0;
+        // the bus free time between a stop and a start
+        push(now + 2 * ARM_HALF_BIT, ev_arm_step, 0, 0, 0);
+    }
+}
+
+//----------------------------------------------------------------------------
+// The UART links and the other stand-ins
+
+// IR sensor board -> sensor PIC: a numbered frame every ir_period, or as
+// often as the line allows
+static sim_time ir_period;
+static sim_time ir_line_free;
+static unsigned long ir_queued;
+static unsigned long ir_sent;
+static unsigned long ir_skipped;
+static sim_time ir_sent_at[65536];
+
+static void ir_frame(unsigned short seq, unsigned char *frame) {
+    frame[0] = seq & 0xFF;
+    frame[1] = seq >> 8;
+    frame[2] = 0x5A;
+    frame[3] = 0xC3 ^ frame[0];
+    frame[4] = 0x77;
+}
+
+// sensor PIC -> master PIC: the replies to the master's reads, with the
+// frame found wherever it is in them (after a block count, before a CRC,
+// in a keyframe; a delta is not timed)
+static struct {
+    unsigned char buf[32];
+    int len;
+    unsigned long frames;
+    unsigned short last;
+    samples latency;
+} gather;
+
+static void gather_read(unsigned char data) {
+    if (gather.len < (int) sizeof (gather.buf)) {
+        gather.buf[gather.len++] = data;
+    }
+}
+
+static void gather_end(void) {
+    unsigned char want[IR_FRAMELEN];
+    unsigned short seq;
+    int i;
+
+    for (i = 0; i + IR_FRAMELEN <= gather.len; i++) {
+        seq = gather.buf[i] | (gather.buf[i + 1] << 8);
+        ir_frame(seq, want);
+        if ((memcmp(gather.buf + i, want, IR_FRAMELEN) == 0) && ir_sent_at[seq]
+                && (!gather.frames || (seq != gather.last))) {
+            gather.frames++;
+            gather.last = seq;
+            sample(&gather.latency, now - ir_sent_at[seq]);
+            break;
+        }
+    }
+    gather.len = 0;
+}
+
+static void ev_ir_byte(int i, int unused, unsigned seq) {
+    unsigned char frame[IR_FRAMELEN];
+
+    (void) unused;
+    ir_frame(seq, frame);
+    nodes[NODE_SENSOR].pic->uart_rx(frame[i], 0);
+    if (i == IR_FRAMELEN - 1) {
+        ir_sent_at[seq & 0xFFFF] = now;
+        ir_sent++;
+    }
+}
+
+static void ev_ir_tick(int unused, int unused2, unsigned unused3) {
+    sim_time bit = nodes[NODE_SENSOR].pic->uart_bit();
+    int i;
+
+    (void) unused;
+    (void) unused2;
+    (void) unused3;
+    push(now + ir_period, ev_ir_tick, 0, 0, 0);
+    if (!bit) {
+        return;
+    }
+    if (ir_line_free > now + ir_period) {
+        ir_skipped++;
+        return;
+    }
+    if (ir_line_free < now) {
+        ir_line_free = now;
+    }
+    for (i = 0; i < IR_FRAMELEN; i++) {
+        ir_line_free += 10 * bit;
+        push(ir_line_free, ev_ir_byte, i, 0, ir_queued);
+    }
+    ir_queued++;
+}
+
+// master PIC -> PC: the frames, forwarded
+static struct {
+    unsigned char buf[IR_FRAMELEN];
+    int len;
+    unsigned long frames;
+    unsigned long empty;
+    unsigned long garbage;
+    unsigned long lost;
+    unsigned long repeated;
+    unsigned long next;
+    sim_time latency;
+    sim_time latency_max;
+    sim_time latency_min;
+    samples latencies;
+} pc;
+
+static void pc_rx(unsigned char data) {
+    unsigned char want[IR_FRAMELEN];
+    unsigned long seq;
+    sim_time latency;
+    int i;
+
+    pc.buf[pc.len++] = data;
+    if (pc.len < IR_FRAMELEN) {
+        return;
+    }
+    pc.len = 0;
+    for (i = 0; (i < IR_FRAMELEN) && (pc.buf[i] == 0); i++) {
+    }
+    if (i == IR_FRAMELEN) {
+        // a read that found nothing new
+        pc.empty++;
+        return;
+    }
+    seq = (pc.next & ~0xFFFFUL) | pc.buf[0] | (pc.buf[1] << 8);
+    ir_frame(seq, want);
+    if (memcmp(pc.buf, want, IR_FRAMELEN) != 0) {
+        pc.garbage++;
+        // get back in step a byte at a time
+        memmove(pc.buf, pc.buf + 1, IR_FRAMELEN - 1);
+        pc.len = IR_FRAMELEN - 1;
+        return;
+    }
+    if (seq < pc.next) {
+        pc.repeated++;
+        return;
+    }
+    pc.lost += seq - pc.next;
+    pc.next = seq + 1;
+    pc.frames++;
+    latency = now - ir_sent_at[seq & 0xFFFF];
+    sample(&pc.latencies, latency);
+    pc.latency += latency;
+    if (latency > pc.latency_max) {
+        pc.latency_max = latency;
+    }
+    if (!pc.latency_min || (latency < pc.latency_min)) {
+        pc.latency_min = latency;
+    }
+}
+
+// motor PIC -> motor controller: the commands that were acked, in order
+static struct {
+    unsigned char buf[MOTOR_CMDLEN];
+    int len;
+    unsigned long commands;
+    unsigned long missing;
+    unsigned long unexpected;
+    unsigned long junk;
+    samples latency;
+} motor;
+
+static void motor_rx(unsigned char data) {
+    unsigned char seq;
+
+    if ((motor.len == 0) && (data != 0xBA)) {
+        motor.junk++;
+        return;
+    }
+    motor.buf[motor.len++] = data;
+    if (motor.len < MOTOR_CMDLEN) {
+        return;
+    }
+    motor.len = 0;
+    seq = motor.buf[1];
+    if ((motor.buf[2] != (unsigned char) ~seq) || (motor.buf[3] != 0x11) || (motor.buf[4] != 0x22)) {
+        motor.junk++;
+        return;
+    }
+    while ((arm.head != arm.tail) && (arm.acked[arm.head] != seq)) {
+        motor.missing++;
+        arm.head = (arm.head + 1) % FIFO_LEN;
+    }
+    if (arm.head == arm.tail) {
+        motor.unexpected++;
+        return;
+    }
+    sample(&motor.latency, now - arm.acked_at[arm.head]);
+    arm.head = (arm.head + 1) % FIFO_LEN;
+    motor.commands++;
+}
+
+static unsigned long sensor_tx;
+
+static void ev_uart(int n, int data, unsigned unused) {
+    (void) unused;
+    nodes[n].pic->event(SIM_EV_TXDONE, 0);
+    switch (n) {
+        case NODE_SENSOR:
+            sensor_tx++;
+            break;
+        case NODE_MOTOR:
+            motor_rx(data);
+            break;
+        case NODE_MASTER:
+            pc_rx(data);
+            break;
+    }
+}
+
+static void host_uart_tx(int n, unsigned char data, sim_time bit) {
+    // a start bit, eight data bits and a stop bit
+    push(now + 10 * bit, ev_uart, n, data, 0);
+}
+
+// the data-ready line, sensor PIC -> master PIC
+static unsigned long dready_raised;
+static sim_time dready_high;
+static sim_time dready_since;
+
+static void ev_pin(int n, int pin, unsigned level) {
+    if ((n != NODE_SENSOR) || (pin != DREADY_PIN)) {
+        return;
+    }
+    if (level) {
+        dready_raised++;
+        dready_since = now;
+    } else if (dready_since) {
+        dready_high += now - dready_since;
+        dready_since = 0;
+    }
+    nodes[NODE_MASTER].pic->pin_in(pin, level);
+}
+
+static void host_pin(int n, int pin, int level) {
+    push(now, ev_pin, n, pin, level);
+}
+
+//----------------------------------------------------------------------------
+
+static sim_host host = {
+    host_now,
+    host_wait,
+    host_at,
+    host_i2c_op,
+    host_i2c_release,
+    host_uart_tx,
+    host_pin,
+    150,
+    200
+};
+
+static double percent(sim_time part, sim_time whole) {
+    return (whole ? 100.0 * part / whole : 0.0);
+}
+
+static void report(void) {
+    sim_pic_stats s;
+    sim_time baud;
+    int n;
+    int i;
+
+    printf("simulated %.3f s\n\n", MS(end) / 1000);
+
+    printf("I2C bus: %lu transactions, busy %.1f%%, waiting on a held clock %.1f%%, %lu NACKs\n",
+            bus.transactions, percent(bus.busy, end), percent(bus.stalled, end), bus.nacks);
+    for (i = 0; i < NUM_MASTERS; i++) {
+        if (masters[i].starts || masters[i].lost) {
+            printf("    %-7s at %3.0f kHz: %lu starts, lost the bus %lu times\n", masters[i].name,
+                    SIM_FOSC / 2000.0 / half_bit(&masters[i]), masters[i].starts, masters[i].lost);
+        }
+    }
+    for (n = 0; n < NUM_NODES; n++) {
+        if (nodes[n].holds) {
+            printf("    %-7s held the clock %lu times, for %.3f ms in all, %.1f us at most\n",
+                    nodes[n].name, nodes[n].holds, MS(nodes[n].held), US(nodes[n].held_max));
+        }
+        if (bus.held & (1 << n)) {
+            printf("    %-7s is still holding the clock, since %.3f ms\n",
+                    nodes[n].name, MS(nodes[n].hold_from));
+        }
+    }
+    if (bus.state != BUS_IDLE) {
+        printf("    the bus is in the middle of a transaction at the end\n");
+    }
+
+    if (dready_since) {
+        dready_high += end - dready_since;
+    }
+    printf("\nIR frames: %lu sent, %lu at the PC (%lu missing, %lu repeated, %lu corrupt), "
+            "%lu empty reads\n", ir_sent, pc.frames, pc.lost, pc.repeated, pc.garbage, pc.empty);
+    if (ir_skipped) {
+        printf("    (%lu more were not sent, as the line was still busy)\n", ir_skipped);
+    }
+    if (gather.frames) {
+        printf("    into the sensor PIC to read by the master: p50 %.3f ms, p99 %.3f ms, "
+                "%.3f ms at most (%lu frames)\n", MS(percentile(&gather.latency, 50)),
+                MS(percentile(&gather.latency, 99)), MS(percentile(&gather.latency, 100)),
+                gather.frames);
+    }
+    if (pc.frames) {
+        printf("    IR board to PC: %.3f ms at least, %.3f ms on average, p50 %.3f ms, "
+                "p99 %.3f ms, %.3f ms at most\n", MS(pc.latency_min), MS(pc.latency / pc.frames),
+                MS(percentile(&pc.latencies, 50)), MS(percentile(&pc.latencies, 99)),
+                MS(pc.latency_max));
+    }
+    printf("    data-ready raised %lu times, high %.1f%% of the time\n",
+            dready_raised, percent(dready_high, end));
+
+    if (arm.period) {
+        printf("\nmotor commands: %lu written (%lu skipped while the last was going), "
+                "%lu acked, %lu refused as full, %lu NACKed\n",
+                arm.commands, arm.skipped, arm.ok, arm.full, arm.nacked);
+        printf("    %lu at the motor controller (%lu missing, %lu unexpected, %lu bytes of junk); "
+                "queue depth up to %u\n", motor.commands, motor.missing, motor.unexpected,
+                motor.junk, arm.depth_max);
+        if (motor.commands) {
+            printf("    written to the motor controller: p50 %.3f ms, p99 %.3f ms, %.3f ms at most\n",
+                    MS(percentile(&motor.latency, 50)), MS(percentile(&motor.latency, 99)),
+                    MS(percentile(&motor.latency, 100)));
+        }
+    }
+
+    printf("\n%-7s %9s %9s %8s %8s %9s %8s %7s %8s %6s %8s\n", "PIC", "high ints", "low ints",
+            "in ints", "asleep", "wakeups", "UART rx", "overrun", "UART tx", "SSPOV", "no buffer");
+    for (n = 0; n < NUM_NODES; n++) {
+        nodes[n].pic->stats(&s);
+        printf("%-7s %9lu %9lu %7.1f%% %7.1f%% %9lu %8lu %7lu %8lu %6lu %8lu\n", nodes[n].name,
+                s.isr_high, s.isr_low, percent(s.isr_time, end), percent(s.sleep_time, end),
+                s.wakeups, s.rx_bytes, s.rx_overruns, s.tx_bytes, s.sspov, s.pool_empty);
+    }
+    printf("\n%-7s %10s %10s %10s %10s %10s   (host CPU ns in the handlers)\n", "PIC",
+            "per high", "per low", "SSPIF p50", "p90", "p99");
+    for (n = 0; n < NUM_NODES; n++) {
+        nodes[n].pic->stats(&s);
+        printf("%-7s %10.0f %10.0f %10lu %10lu %10lu\n", nodes[n].name,
+                s.isr_high ? (double) s.isr_high_ns / s.isr_high : 0.0,
+                s.isr_low ? (double) s.isr_low_ns / s.isr_low : 0.0,
+                ns_percentile(&s, 50), ns_percentile(&s, 90), ns_percentile(&s, 99));
+    }
+    baud = nodes[NODE_SENSOR].pic->uart_bit();
+    if (baud) {
+        printf("(UARTs at %.0f baud; %lu bytes out of the sensor PIC)\n", (double) SIM_FOSC / baud,
+                sensor_tx);
+    }
+}
+
+// One line for each path, the same from run to run and build to build, for
+// comparing them: what was offered, what got through, what was dropped
+// (lost, refused, or never sent because the last was still going), the
+// rate that got through and the latency percentiles in ms.  The gather
+// path is timed from the frame going into the sensor PIC to the reply
+// read by the master, and on to the PC; the move path from the 0xBA write
+// to the motor controller.
+
+static void bench(void) {
+    double seconds = MS(end) / 1000;
+
+    printf("gather every %7.3f ms: %7lu offered %7lu through %6lu dropped %8.1f/s"
+            "  reply p50 %.3f p99 %.3f max %.3f  PC p50 %.3f p99 %.3f max %.3f\n",
+            MS(ir_period), ir_sent + ir_skipped, pc.frames, pc.lost + ir_skipped,
+            pc.frames / seconds, MS(percentile(&gather.latency, 50)),
+            MS(percentile(&gather.latency, 99)), MS(percentile(&gather.latency, 100)),
+            MS(percentile(&pc.latencies, 50)), MS(percentile(&pc.latencies, 99)),
+            MS(percentile(&pc.latencies, 100)));
+    if (arm.period) {
+        printf("move   every %7.3f ms: %7lu offered %7lu through %6lu dropped %8.1f/s"
+                "  write p50 %.3f p99 %.3f max %.3f\n",
+                MS(arm.period), arm.commands + arm.skipped, motor.commands,
+                arm.skipped + arm.full + arm.nacked + motor.missing, motor.commands / seconds,
+                MS(percentile(&motor.latency, 50)), MS(percentile(&motor.latency, 99)),
+                MS(percentile(&motor.latency, 100)));
+    }
+}
+
+static void usage(void) {
+    fprintf(stderr, "usage: sim [-t seconds] [-f ms between IR frames] "
+            "[-m ms between motor commands] [-i cycles per interrupt] "
+            "[-w cycles per pass of main()] [-d dir] [-b] [-v]\n");
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    double seconds = 10;
+    double frame_ms = 20;
+    double motor_ms = 50;
+    const char *dir = ".";
+    int bench_only = 0;
+    int opt;
+
+    while ((opt = getopt(argc, argv, "t:f:m:i:w:d:bv")) != -1) {
+        switch (opt) {
+            case 't': seconds = atof(optarg); break;
+            case 'f': frame_ms = atof(optarg); break;
+            case 'm': motor_ms = atof(optarg); break;
+            case 'i': host.isr_tcy = strtoul(optarg, 0, 0); break;
+            case 'w': host.main_tcy = strtoul(optarg, 0, 0); break;
+            case 'd': dir = optarg; break;
+            case 'b': bench_only = 1; break;
+            case 'v': verbose = 1; break;
+            default: usage();
+        }
+    }
+    if ((seconds <= 0) || (frame_ms <= 0) || (motor_ms < 0) || !host.isr_tcy) {
+        usage();
+    }
+    end = seconds * SIM_FOSC;
+    ir_period = frame_ms * SIM_FOSC / 1000;
+    arm.period = motor_ms * SIM_FOSC / 1000;
+
+    sched_node("sim", dir, "sensor", "SENSORPIC.so", &host);
+    sched_node("sim", dir, "motor", "MOTORPIC.so", &host);
+    sched_node("sim", dir, "master", "I2CMASTER.so", &host);
+    sched_start();
+    // the stand-ins start once the PICs are up
+    push(SIM_FOSC / 10, ev_ir_tick, 0, 0, 0);
+    if (arm.period) {
+        push(SIM_FOSC / 10 + arm.period / 2, ev_arm_tick, 0, 0, 0);
+    }
+
+    sched_run();
+    if (bench_only) {
+        bench();
+    } else {
+        report();
+    }
+    // (the PICs are left waiting for the CPU)
+    exit(0);
+}
@@ -0,0 +1,135 @@
+#ifndef __sim_h
+#define __sim_h
+
+// Between the simulator (sim.c) and each simulated PIC (pic.c)
+//
+// The simulator keeps the clock and the event queue, runs the I2C bus and
+// the UART links, and passes the CPU from one node to the next.  Each PIC
+// is a shared object with its own copy of the firmware and of the SFRs,
+// and only ever runs while the simulator has handed it the CPU, so there
+// is never more than one thread touching anything.
+
+// Time is counted in cycles of the 48 MHz oscillator, four to an
+// instruction cycle
+typedef unsigned long long sim_time;
+#define SIM_FOSC 48000000ULL
+#define SIM_TCY 4
+#define SIM_FOREVER (~0ULL)
+
+// what the MSSP of a master asks the bus to do
+enum {
+    SIM_I2C_START,
+    SIM_I2C_RESTART,
+    SIM_I2C_WRITE,
+    SIM_I2C_READ,
+    SIM_I2C_ACK,
+    SIM_I2C_STOP
+};
+
+// what a slave did with an address, a data byte or the master's ACK
+#define SIM_I2C_ACKED 1
+#define SIM_I2C_HOLD 2
+
+// errors a byte into the EUSART can come with (their bits in RCSTA)
+#define SIM_UART_FERR 0x04
+#define SIM_UART_OERR 0x02
+
+// timer and UART events a PIC asks to be called back with
+enum {
+    SIM_EV_TMR0,
+    SIM_EV_TMR1,
+    SIM_EV_TXDONE
+};
+
+// where a message from the firmware went: to main(), or along a route of
+// routes.h (SIM_MSG_ROUTE + the route)
+enum {
+    SIM_MSG_TO_MAIN_HIGH,
+    SIM_MSG_TO_MAIN_LOW,
+    SIM_MSG_ROUTE
+};
+
+typedef struct sim_host {
+    sim_time (*now)(void);
+    // Gives up the CPU until the time given, or until an interrupt would
+    // wake the node (if wake is set)
+    void (*wait)(int node, sim_time until, int wake);
+    // calls the node's event() at the time given
+    void (*at)(int node, sim_time when, int kind, unsigned arg);
+    // The rest take effect at the time they are called, through the event
+    // queue
+    void (*i2c_op)(int node, int op, unsigned char data);
+    void (*i2c_release)(int node);
+    void (*uart_tx)(int node, unsigned char data, sim_time bit);
+    void (*pin)(int node, int pin, int level);
+    // instruction cycles charged for each interrupt and each pass of main()
+    unsigned long isr_tcy;
+    unsigned long main_tcy;
+    // (if set) each message the firmware sends to main() or along a route,
+    // and whether the queue took it; only with the firmware linked with
+    // the --wrap flags of the Makefile
+    void (*message)(int node, int queue, int sent, unsigned char msgtype,
+            unsigned char length, const unsigned char *data);
+} sim_host;
+
+#define SIM_NS_BUCKET 10
+#define SIM_NS_BUCKETS 500
+
+typedef struct sim_pic_stats {
+    unsigned long isr_high;
+    unsigned long isr_low;
+    sim_time isr_time;
+    // host CPU time in the firmware's handlers (not simulated time: the
+    // only measure here of how much work each one does)
+    unsigned long long isr_high_ns;
+    unsigned long long isr_low_ns;
+    // and in the interrupts taken for SSPIF (at whichever priority), with
+    // how many took each SIM_NS_BUCKET ns (the last for all the longer ones)
+    unsigned long ssp_isrs;
+    unsigned long long ssp_ns;
+    unsigned long ssp_ns_hist[SIM_NS_BUCKETS];
+    unsigned long sleeps;
+    sim_time sleep_time;
+    unsigned long wakeups;
+    unsigned long collisions;
+    unsigned long sspov;
+    unsigned long rx_overruns;
+    unsigned long tx_bytes;
+    unsigned long rx_bytes;
+    // sends that found the message pool empty
+    unsigned long pool_empty;
+} sim_pic_stats;
+
+typedef struct sim_pic {
+    // boots the firmware (in the node's own thread); never returns
+    void (*run)(void);
+    // whether an interrupt would wake the node now
+    int (*wake)(void);
+    void (*event)(int kind, unsigned arg);
+    // the MSSP as a master: half a bit in oscillator cycles, and the end
+    // of an operation it asked for (or of the arbitration it lost)
+    sim_time (*i2c_half_bit)(void);
+    void (*i2c_done)(int op, int acked, unsigned char data);
+    void (*i2c_lost)(void);
+    // the MSSP as a slave (or any MSSP, for the start and stop)
+    void (*i2c_start)(void);
+    int (*i2c_address)(unsigned char);
+    int (*i2c_write)(unsigned char);
+    unsigned char (*i2c_read)(void);
+    int (*i2c_ack)(int);
+    void (*i2c_stop)(void);
+    // the EUSART: a byte in (with its framing error, or after an overrun
+    // the receiver missed, as SIM_UART_* flags), and the bit time it was
+    // set up for (0 if not)
+    void (*uart_rx)(unsigned char, int);
+    sim_time (*uart_bit)(void);
+    // an input on PORTB changed
+    void (*pin_in)(int pin, int level);
+    void (*stats)(sim_pic_stats *);
+} sim_pic;
+
+// each node's shared object exports this
+typedef const sim_pic *(*sim_pic_init_fn)(const sim_host *, int);
+#define SIM_PIC_INIT "sim_pic_init"
+
+#endif
@@ -0,0 +1,246 @@
+// The clock, the event queue and the PICs (see simsched.h)
+
+#define _GNU_SOURCE
+#include <dlfcn.h>
+#include <pthread.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "simsched.h"
+
+sim_time now;
+sim_time end;
+int verbose;
+
+void trace(const char *fmt, ...) {
+    va_list ap;
+
+    if (verbose) {
+        printf("%12.6f ms  ", MS(now));
+        va_start(ap, fmt);
+        vprintf(fmt, ap);
+        va_end(ap);
+        printf("\n");
+    }
+}
+
+//----------------------------------------------------------------------------
+// Events, kept in a heap by time (and by the order they were added)
+
+typedef struct event {
+    sim_time t;
+    unsigned long seq;
+    void (*fn)(int, int, unsigned);
+    int a;
+    int b;
+    unsigned c;
+} event;
+
+static event *heap;
+static int heap_len;
+static int heap_size;
+static unsigned long heap_seq;
+
+static int before(const event *x, const event *y) {
+    return ((x->t < y->t) || ((x->t == y->t) && (x->seq < y->seq)));
+}
+
+void push(sim_time t, void (*fn)(int, int, unsigned), int a, int b, unsigned c) {
+    event e = {t, heap_seq++, fn, a, b, c};
+    int i;
+
+    if (heap_len == heap_size) {
+        heap_size = heap_size ? 2 * heap_size : 64;
+        heap = realloc(heap, heap_size * sizeof (event));
+        if (!heap) {
+            perror("simsched");
+            exit(1);
+        }
+    }
+    for (i = heap_len++; (i > 0) && before(&e, &heap[(i - 1) / 2]); i = (i - 1) / 2) {
+        heap[i] = heap[(i - 1) / 2];
+    }
+    heap[i] = e;
+}
+
+static event pop(void) {
+    event top = heap[0];
+    event last = heap[--heap_len];
+    int i = 0;
+    int child;
+
+    for (;;) {
+        child = 2 * i + 1;
+        if (child >= heap_len) {
+            break;
+        }
+        if ((child + 1 < heap_len) && before(&heap[child + 1], &heap[child])) {
+            child++;
+        }
+        if (!before(&heap[child], &last)) {
+            break;
+        }
+        heap[i] = heap[child];
+        i = child;
+    }
+    heap[i] = last;
+    return (top);
+}
+
+//----------------------------------------------------------------------------
+// The PICs, and passing the CPU between them and the scheduler
+
+node nodes[SCHED_MAX_NODES];
+int num_nodes;
+
+static pthread_mutex_t cpu = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t scheduler_turn = PTHREAD_COND_INITIALIZER;
+static int running = SCHEDULER;
+
+static pthread_cond_t *turn_of(int who) {
+    return ((who == SCHEDULER) ? &scheduler_turn : &nodes[who].turn);
+}
+
+// called with cpu held, by whoever is running
+
+static void hand_over(int from, int to) {
+    running = to;
+    pthread_cond_signal(turn_of(to));
+    while (running != from) {
+        pthread_cond_wait(turn_of(from), &cpu);
+    }
+}
+
+static void *node_thread(void *arg) {
+    int self = (node *) arg - nodes;
+
+    pthread_mutex_lock(&cpu);
+    while (running != self) {
+        pthread_cond_wait(turn_of(self), &cpu);
+    }
+    nodes[self].pic->run();
+    return (arg);
+}
+
+static void ev_wake(int n, int unused, unsigned gen) {
+    (void) unused;
+    if (nodes[n].waiting && (gen == nodes[n].gen)) {
+        hand_over(SCHEDULER, n);
+    }
+}
+
+// a node waiting for an interrupt that now has one is run at once
+
+static void kick(void) {
+    int n;
+
+    for (n = 0; n < num_nodes; n++) {
+        if (nodes[n].waiting && nodes[n].wake && nodes[n].pic->wake()) {
+            nodes[n].wake = 0;
+            push(now, ev_wake, n, 0, ++nodes[n].gen);
+        }
+    }
+}
+
+sim_time host_now(void) {
+    return (now);
+}
+
+void host_wait(int n, sim_time until, int wake) {
+    node *np = &nodes[n];
+
+    if (wake && np->pic->wake()) {
+        return;
+    }
+    // nothing else happens first, so there is no need to stop
+    if ((until < end) && ((heap_len == 0) || (until < heap[0].t))) {
+        now = until;
+        return;
+    }
+    np->waiting = 1;
+    np->wake = wake;
+    np->gen++;
+    if (until != SIM_FOREVER) {
+        push(until, ev_wake, n, 0, np->gen);
+    }
+    hand_over(n, SCHEDULER);
+    np->waiting = 0;
+}
+
+static void ev_pic(int n, int kind, unsigned arg) {
+    nodes[n].pic->event(kind, arg);
+}
+
+void host_at(int n, sim_time when, int kind, unsigned arg) {
+    push(when, ev_pic, n, kind, arg);
+}
+
+// each in its own namespace, so each has its own globals
+
+int sched_node(const char *prog, const char *dir, const char *name, const char *lib,
+        const sim_host *host) {
+    node *np = &nodes[num_nodes];
+    char path[4096];
+    sim_pic_init_fn init;
+    void *handle;
+
+    if (num_nodes == SCHED_MAX_NODES) {
+        fprintf(stderr, "%s: too many nodes\n", prog);
+        exit(1);
+    }
+    snprintf(path, sizeof (path), "%s/%s", dir, lib);
+    handle = dlopen(path, RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        fprintf(stderr, "%s: %s\n", prog, dlerror());
+        exit(1);
+    }
+    init = (sim_pic_init_fn) dlsym(handle, SIM_PIC_INIT);
+    if (!init) {
+        fprintf(stderr, "%s: %s\n", prog, dlerror());
+        exit(1);
+    }
+    np->name = name;
+    np->lib = lib;
+    np->pic = init(host, num_nodes);
+    pthread_cond_init(&np->turn, 0);
+    return (num_nodes++);
+}
+
+void sched_start(void) {
+    int n;
+
+    pthread_mutex_lock(&cpu);
+    for (n = 0; n < num_nodes; n++) {
+        pthread_create(&nodes[n].thread, 0, node_thread, &nodes[n]);
+        nodes[n].waiting = 1;
+        push(0, ev_wake, n, 0, nodes[n].gen);
+    }
+}
+
+void sched_run(void) {
+    event e;
+
+    while ((heap_len > 0) && (heap[0].t <= end)) {
+        e = pop();
+        now = e.t;
+        e.fn(e.a, e.b, e.c);
+        kick();
+    }
+    now = end;
+}
+
+unsigned long ns_percentile(const sim_pic_stats *sp, int p) {
+    unsigned long long seen = 0;
+    int i;
+
+    if (sp->ssp_isrs == 0) {
+        return (0);
+    }
+    for (i = 0; i < SIM_NS_BUCKETS - 1; i++) {
+        seen += sp->ssp_ns_hist[i];
+        if (seen * 100 >= (unsigned long long) sp->ssp_isrs * p) {
+            break;
+        }
+    }
+    return ((unsigned long) (i + 1) * SIM_NS_BUCKET);
+}
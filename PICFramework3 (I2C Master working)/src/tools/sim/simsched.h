@@ -0,0 +1,69 @@
+#ifndef __simsched_h
+#define __simsched_h
+
+#include <pthread.h>
+#include "sim.h"
+
+// The clock, the event queue and the PICs, for the host programs that run
+// firmware built with pic.c (sim.c, stress.c and replay.c)
+//
+// Each PIC has its own thread, but only runs while the scheduler has
+// handed it the CPU, and hands it back from host_wait() once its
+// simulated time has to stop.  The scheduler takes the events in order of
+// time (and of when they were pushed), so a run is the same every time.
+// The program supplies the rest of the sim_host: the bus, the UART links
+// and the pins.
+
+#define MS(t) ((double) (t) * 1000.0 / SIM_FOSC)
+#define US(t) ((double) (t) * 1000000.0 / SIM_FOSC)
+
+#define SCHED_MAX_NODES 3
+#define SCHEDULER (-1)
+
+typedef struct node {
+    const char *name;
+    const char *lib;
+    const sim_pic *pic;
+    pthread_t thread;
+    pthread_cond_t turn;
+    // stopped in wait(), and whether an interrupt can end that
+    int waiting;
+    int wake;
+    unsigned gen;
+    // holding the I2C clock low
+    sim_time hold_from;
+    unsigned long holds;
+    sim_time held;
+    sim_time held_max;
+} node;
+
+extern sim_time now;
+extern sim_time end;
+extern int verbose;
+extern node nodes[SCHED_MAX_NODES];
+extern int num_nodes;
+
+// prints a line with the time in front, with -v
+void trace(const char *, ...);
+// calls fn(a, b, c) at time t
+void push(sim_time t, void (*fn)(int, int, unsigned), int a, int b, unsigned c);
+
+// Adds a node running the shared object lib (in dir) and returns its
+// number; exits if it can't be loaded
+int sched_node(const char *prog, const char *dir, const char *name, const char *lib,
+        const sim_host *host);
+// Boots the PICs at time 0 (their events go ahead of any pushed after)
+void sched_start(void);
+// Runs the events up to end, or until there are none
+void sched_run(void);
+
+// the scheduler's part of a sim_host
+sim_time host_now(void);
+void host_wait(int, sim_time, int);
+void host_at(int, sim_time, int, unsigned);
+
+// the host CPU time under which p percent of a PIC's SSPIF interrupts
+// were handled, to the SIM_NS_BUCKET
+unsigned long ns_percentile(const sim_pic_stats *, int);
+
+#endif
@@ -0,0 +1,720 @@
+// A randomized stress test of one slave PIC's I2C handling, on the
+// simulator's PIC (pic.c) and scheduler (simsched.c).  A master that keeps
+// to the slave's clock stretching sends it transactions picked at random:
+//
+//     write       a command and up to MSGLEN - 3 bytes after it
+//     write+read  a command, a repeated start and a read of the reply
+//     empty       an address for a write and then the stop
+//     read        one byte
+//     reads       two to four reads, back to back with repeated starts
+//     restart     a write cut short by a repeated start and another write
+//     start+stop  nothing in between
+//     wrong addr  an address the slave must not answer
+//     long        a write longer than the slave's buffer
+//     overread    a write+read that clocks out more than any reply
+//     burst       a write at eight times the clock that does not wait for
+//                 the stretched clock (a master that can't do clock
+//                 stretching), which overruns the slave
+//
+// with a random gap between them, none at all one time in eight, and
+// every so often a probe that only checks that the slave still ACKs its
+// address and lets go of the clock.  The commands are the ones the slaves
+// know, and with -r a random byte one time in four.  A slave that holds
+// the clock longer than the limit is counted, and the master goes on to
+// the stop as if it had timed out.  Without SMBUS_BLOCK a slave has no
+// reply to a read after a command it doesn't have in the build (and holds
+// the clock for good), so the first time that happens the command is put
+// aside: it is still written, but not read after, and a read that would
+// follow it gets a write of another command in front.
+//
+// The report gives the transactions per second, in simulated time and in
+// host time, what each kind of transaction ran into, how long the clock
+// was held, how many probes failed, the cost of each I2C interrupt (the
+// flat -i charge, and the host CPU time the handler took), and a histogram
+// of the errors the firmware reported to main() (MSGT_I2C_DBG, seen
+// through the --wrap of pic.c).  The run is the same for the same seed.
+//
+// Build on the host with "make sim" in the directory above (see the
+// Makefile there), which builds the PICs with the --wrap flags this needs,
+// and run it as
+//     ./stress [-n transactions] [-s seed] [-k kHz] [-g us of gap at most]
+//              [-p transactions between probes] [-r] [-a slave address]
+//              [-l PIC's shared object] [-i instruction cycles per
+//              interrupt] [-w instruction cycles per pass of main()]
+//              [-d dir of the .so] [-v]
+// which by default sends 20000 transactions at 400 kHz, with up to 50 us
+// between them and a probe every 100, to SENSORPIC.so at 0x9E; -v prints
+// every bus operation and every message to main().  "make stress" runs it
+// on the sensor and the motor PIC.  It exits with 1 if a probe failed or
+// the clock was held past the limit other than for a command with no
+// reply.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include "simsched.h"
+
+// as in maindefs.h, messages.h and my_i2c.h
+#define SENSOR_ADDR 0x9E
+#define MSGLEN 10
+#define MSGT_I2C_DATA 40
+#define MSGT_I2C_DBG 41
+#define I2C_ERR_OVERRUN 0x4
+#define NUM_ERRS 5
+
+static const char *err_names[NUM_ERRS] = {
+    "overrun", "no address", "no data", "too long", "truncated"
+};
+
+// the commands the slaves answer to
+static const unsigned char commands[] = {
+    0xAA, 0xAB, 0xAC, 0xBA, 0xBB, 0xBC, 0xCA, 0xCB, 0xCC, 0xCD, 0xCE, 0xCF, 0xDA
+};
+#define NUM_COMMANDS (sizeof (commands) / sizeof (commands[0]))
+
+#define HOLD_LIMIT (SIM_FOSC / 100)
+#define NO_CMD (-1)
+#define BURST 8
+
+static const char *op_names[] = {"START", "RESTART", "WRITE", "READ", "ACK", "STOP"};
+
+//----------------------------------------------------------------------------
+// The transactions
+
+enum {
+    K_WRITE,
+    K_WRITE_READ,
+    K_EMPTY,
+    K_READ,
+    K_READS,
+    K_RESTART,
+    K_START_STOP,
+    K_WRONG_ADDR,
+    K_LONG,
+    K_OVERREAD,
+    K_BURST,
+    K_PROBE,
+    NUM_KINDS
+};
+
+static const char *kind_names[NUM_KINDS] = {
+    "write", "write+read", "empty", "read", "reads", "restart", "start+stop",
+    "wrong addr", "long", "overread", "burst", "probe"
+};
+
+#define MAX_STEPS 128
+
+typedef struct step {
+    int op;
+    unsigned char data;
+} step;
+
+static struct {
+    int kind;
+    step steps[MAX_STEPS];
+    int num_steps;
+    int next;
+    // the operation on the bus, and its data
+    int busy;
+    unsigned char data;
+    // the slave was addressed by the last address, for a read
+    int addr_next;
+    int addressed;
+    int reading;
+    // the next byte written is the command
+    int first;
+    // a NACK that was not asked for (the address, or a byte written)
+    int nacked;
+    int timed_out;
+} tx;
+
+static struct {
+    unsigned long count;
+    unsigned long total;
+    unsigned long done;
+    unsigned long probe_every;
+    sim_time gap_max;
+    sim_time half_bit;
+    unsigned char addr;
+    int random_commands;
+    // the command the slave has (NO_CMD if it can't be told), and those it
+    // has no reply to
+    int last_cmd;
+    unsigned char no_reply[256];
+    unsigned long kinds[NUM_KINDS];
+    unsigned long nacks[NUM_KINDS];
+    unsigned long timeouts[NUM_KINDS];
+    unsigned long bytes_written;
+    unsigned long bytes_read;
+    unsigned long probes_failed;
+    unsigned long writes_with_data;
+    sim_time started;
+} run;
+
+// the slave holding the clock
+static struct {
+    int held;
+    unsigned gen;
+    int for_reply;
+    unsigned long overlong;
+    unsigned long overlong_reply;
+} clk;
+
+// what the firmware sent to main()
+static struct {
+    unsigned long data;
+    unsigned long dbg;
+    unsigned long other;
+    unsigned long dropped;
+    unsigned long errors[NUM_ERRS];
+    unsigned long unknown;
+} msgs;
+
+static unsigned long rnd_state;
+
+static unsigned long rnd(unsigned long n) {
+    // (the 64-bit LCG of Knuth's MMIX)
+    rnd_state = rnd_state * 6364136223846793005UL + 1442695040888963407UL;
+    return ((rnd_state >> 33) % n);
+}
+
+static void add(int op, unsigned char data) {
+    if (tx.num_steps < MAX_STEPS) {
+        tx.steps[tx.num_steps].op = op;
+        tx.steps[tx.num_steps].data = data;
+        tx.num_steps++;
+    }
+}
+
+// a command, for a read to follow if replied is set
+
+static unsigned char command(int replied) {
+    unsigned char cmd = 0;
+    int tries;
+
+    for (tries = 0; tries < 64; tries++) {
+        if (run.random_commands && (rnd(4) == 0)) {
+            cmd = rnd(256);
+        } else {
+            cmd = commands[rnd(NUM_COMMANDS)];
+        }
+        if (!replied || !run.no_reply[cmd]) {
+            break;
+        }
+    }
+    return (cmd);
+}
+
+static void add_write_for(int n, int replied) {
+    int i;
+
+    if (n > 0) {
+        add(SIM_I2C_WRITE, command(replied));
+    }
+    for (i = 1; i < n; i++) {
+        add(SIM_I2C_WRITE, rnd(256));
+    }
+    run.writes_with_data += (n > 0);
+}
+
+static void add_write(int n) {
+    add_write_for(n, 0);
+}
+
+// a write of a command with a reply, unless the last one has one
+
+static void add_replied(unsigned char r) {
+    if ((run.last_cmd == NO_CMD) || run.no_reply[run.last_cmd]) {
+        add(SIM_I2C_WRITE, r & 0xFE);
+        add_write_for(1, 1);
+        add(SIM_I2C_RESTART, 0);
+    }
+}
+
+// n bytes, the last one NACKed
+
+static void add_read(int n) {
+    int i;
+
+    for (i = 0; i < n; i++) {
+        add(SIM_I2C_READ, 0);
+        add(SIM_I2C_ACK, i == n - 1);
+    }
+}
+
+static void make_transaction(int kind) {
+    unsigned char w = run.addr & 0xFE;
+    unsigned char r = run.addr | 1;
+    int i;
+
+    tx.kind = kind;
+    tx.num_steps = 0;
+    tx.next = 0;
+    tx.nacked = 0;
+    tx.timed_out = 0;
+    add(SIM_I2C_START, 0);
+    switch (kind) {
+        case K_WRITE:
+            add(SIM_I2C_WRITE, w);
+            add_write(1 + rnd(MSGLEN - 3));
+            break;
+        case K_WRITE_READ:
+            add(SIM_I2C_WRITE, w);
+            add_write_for(1 + rnd(3), 1);
+            add(SIM_I2C_RESTART, 0);
+            add(SIM_I2C_WRITE, r);
+            add_read(1 + rnd(MSGLEN));
+            break;
+        case K_EMPTY:
+        case K_PROBE:
+            add(SIM_I2C_WRITE, w);
+            break;
+        case K_READ:
+            add_replied(r);
+            add(SIM_I2C_WRITE, r);
+            add_read(1);
+            break;
+        case K_READS:
+            add_replied(r);
+            add(SIM_I2C_WRITE, r);
+            add_read(1 + rnd(MSGLEN));
+            for (i = 1 + rnd(3); i > 0; i--) {
+                add(SIM_I2C_RESTART, 0);
+                add(SIM_I2C_WRITE, r);
+                add_read(1 + rnd(MSGLEN));
+            }
+            break;
+        case K_RESTART:
+            add(SIM_I2C_WRITE, w);
+            add_write(1 + rnd(MSGLEN - 3));
+            add(SIM_I2C_RESTART, 0);
+            add(SIM_I2C_WRITE, w);
+            add_write(1 + rnd(MSGLEN - 3));
+            break;
+        case K_START_STOP:
+            break;
+        case K_WRONG_ADDR:
+            // (the temperature sensor's address, when that is not it)
+            add(SIM_I2C_WRITE, ((w == 0x9A) ? 0x90 : 0x9A) | rnd(2));
+            break;
+        case K_LONG:
+            add(SIM_I2C_WRITE, w);
+            add_write(MSGLEN + 1 + rnd(6));
+            break;
+        case K_OVERREAD:
+            add(SIM_I2C_WRITE, w);
+            add_write_for(1, 1);
+            add(SIM_I2C_RESTART, 0);
+            add(SIM_I2C_WRITE, r);
+            add_read(MSGLEN + 4 + rnd(8));
+            break;
+        case K_BURST:
+            add(SIM_I2C_WRITE, w);
+            add_write(3 + rnd(4));
+            break;
+    }
+    add(SIM_I2C_STOP, 0);
+    run.kinds[kind]++;
+}
+
+//----------------------------------------------------------------------------
+// The master
+
+static void master_next(void);
+
+static sim_time half_bit(void) {
+    if (tx.kind == K_BURST) {
+        return ((run.half_bit + BURST - 1) / BURST);
+    }
+    return (run.half_bit);
+}
+
+static void ev_begin(int unused, int unused2, unsigned unused3) {
+    (void) unused;
+    (void) unused2;
+    (void) unused3;
+    if (run.done == run.count) {
+        // the end, with whatever the PIC was doing left undone
+        end = now;
+        return;
+    }
+    if (run.probe_every && ((run.total + 1) % run.probe_every == 0)) {
+        make_transaction(K_PROBE);
+    } else {
+        make_transaction(rnd(K_PROBE));
+    }
+    run.total++;
+    master_next();
+}
+
+static void transaction_end(void) {
+    sim_time gap = 0;
+
+    if (tx.nacked) {
+        run.nacks[tx.kind]++;
+    }
+    if (tx.timed_out) {
+        run.timeouts[tx.kind]++;
+    }
+    if (tx.timed_out || (tx.kind == K_LONG) || (tx.kind == K_BURST)) {
+        // (the slave may have anything in its buffer)
+        run.last_cmd = NO_CMD;
+    }
+    if ((tx.kind == K_PROBE) && (tx.nacked || tx.timed_out)) {
+        run.probes_failed++;
+        trace("probe failed");
+    }
+    if (tx.kind != K_PROBE) {
+        run.done++;
+    }
+    if (rnd(8) && run.gap_max) {
+        gap = rnd(run.gap_max + 1);
+    }
+    push(now + gap, ev_begin, 0, 0, 0);
+}
+
+static void ev_hold_limit(int unused, int unused2, unsigned gen) {
+    (void) unused;
+    (void) unused2;
+    if (clk.held && (gen == clk.gen)) {
+        trace("the clock has been held for %.3f ms", MS(HOLD_LIMIT));
+        clk.overlong++;
+        if (clk.for_reply && (run.last_cmd != NO_CMD)) {
+            // (the first time only: after this there is no read after it)
+            clk.overlong_reply += !run.no_reply[run.last_cmd];
+            run.no_reply[run.last_cmd] = 1;
+            trace("no reply to %02X", run.last_cmd);
+        }
+        clk.held = 0;
+        nodes[0].held += HOLD_LIMIT;
+        tx.timed_out = 1;
+        tx.next = tx.num_steps - 1;
+        master_next();
+    }
+}
+
+static void hold(int flags, int for_reply) {
+    if ((flags & SIM_I2C_HOLD) && (tx.kind != K_BURST)) {
+        clk.held = 1;
+        clk.for_reply = for_reply;
+        clk.gen++;
+        nodes[0].hold_from = now;
+        nodes[0].holds++;
+        push(now + HOLD_LIMIT, ev_hold_limit, 0, 0, clk.gen);
+    }
+}
+
+static void ev_release(int unused, int unused2, unsigned unused3) {
+    sim_time length = now - nodes[0].hold_from;
+
+    (void) unused;
+    (void) unused2;
+    (void) unused3;
+    if (clk.held) {
+        clk.held = 0;
+        nodes[0].held += length;
+        if (length > nodes[0].held_max) {
+            nodes[0].held_max = length;
+        }
+        master_next();
+    }
+}
+
+static void ev_op_end(int unused, int unused2, unsigned unused3) {
+    const sim_pic *pic = nodes[0].pic;
+    step *s = &tx.steps[tx.next];
+    int acked = 1;
+    int flags = 0;
+
+    (void) unused;
+    (void) unused2;
+    (void) unused3;
+    if ((s->op == SIM_I2C_RESTART) || (s->op == SIM_I2C_STOP)) {
+        if (tx.addressed && !tx.reading && tx.first) {
+            // a write with no data leaves the slave no command
+            run.last_cmd = NO_CMD;
+        }
+    }
+    switch (s->op) {
+        case SIM_I2C_START:
+        case SIM_I2C_RESTART:
+            tx.addr_next = 1;
+            tx.addressed = 0;
+            pic->i2c_start();
+            break;
+        case SIM_I2C_WRITE:
+            if (tx.addr_next) {
+                tx.addr_next = 0;
+                tx.reading = s->data & 1;
+                flags = pic->i2c_address(s->data);
+                tx.addressed = flags & SIM_I2C_ACKED;
+                tx.first = 1;
+            } else if (tx.addressed && !tx.reading) {
+                flags = pic->i2c_write(s->data);
+                run.bytes_written++;
+                if (tx.first && (flags & SIM_I2C_ACKED)) {
+                    run.last_cmd = s->data;
+                }
+                tx.first = 0;
+            }
+            acked = flags & SIM_I2C_ACKED;
+            hold(flags, tx.reading);
+            break;
+        case SIM_I2C_READ:
+            run.bytes_read++;
+            break;
+        case SIM_I2C_ACK:
+            if (tx.addressed && tx.reading) {
+                hold(pic->i2c_ack(s->data), 0);
+            }
+            break;
+        case SIM_I2C_STOP:
+            pic->i2c_stop();
+            break;
+    }
+    trace("%s %02X%s", op_names[s->op], (s->op == SIM_I2C_READ) ? tx.data : s->data,
+            (s->op == SIM_I2C_WRITE) ? (acked ? " ACK" : " NACK") : "");
+    tx.busy = 0;
+    tx.next++;
+    if (!acked) {
+        // on to the stop, unless it was the wrong address on purpose
+        if (tx.kind != K_WRONG_ADDR) {
+            tx.nacked = 1;
+        }
+        tx.next = tx.num_steps - 1;
+    }
+    if (s->op == SIM_I2C_STOP) {
+        transaction_end();
+        return;
+    }
+    master_next();
+}
+
+// the next operation, once the last is over and the slave has let go of
+// the clock
+
+static void master_next(void) {
+    step *s = &tx.steps[tx.next];
+    sim_time h = half_bit();
+    sim_time length = 0;
+
+    if (tx.busy || clk.held) {
+        return;
+    }
+    switch (s->op) {
+        case SIM_I2C_START:
+        case SIM_I2C_ACK:
+        case SIM_I2C_STOP:
+            length = 2 * h;
+            break;
+        case SIM_I2C_RESTART:
+            length = 3 * h;
+            break;
+        case SIM_I2C_WRITE:
+            length = 18 * h;
+            break;
+        case SIM_I2C_READ:
+            length = 16 * h;
+            tx.data = 0xFF;
+            if (tx.addressed && tx.reading) {
+                tx.data = nodes[0].pic->i2c_read();
+            }
+            break;
+    }
+    tx.busy = 1;
+    push(now + length, ev_op_end, 0, 0, 0);
+}
+
+//----------------------------------------------------------------------------
+// The rest of the PIC's world
+
+static void host_i2c_op(int n, int op, unsigned char data) {
+    (void) n;
+    (void) op;
+    (void) data;
+}
+
+static void host_i2c_release(int n) {
+    push(now, ev_release, n, 0, 0);
+}
+
+static void ev_uart(int n, int unused, unsigned unused2) {
+    (void) unused;
+    (void) unused2;
+    nodes[n].pic->event(SIM_EV_TXDONE, 0);
+}
+
+static void host_uart_tx(int n, unsigned char data, sim_time bit) {
+    (void) data;
+    push(now + 10 * bit, ev_uart, n, 0, 0);
+}
+
+static void host_pin(int n, int pin, int level) {
+    (void) n;
+    (void) pin;
+    (void) level;
+}
+
+static void host_message(int n, int queue, int sent, unsigned char msgtype,
+        unsigned char length, const unsigned char *data) {
+    (void) n;
+    if (queue >= SIM_MSG_ROUTE) {
+        return;
+    }
+    trace("to main(): type %d, %d bytes %02X %02X %02X%s", msgtype, length,
+            (length > 0) ? data[0] : 0, (length > 1) ? data[1] : 0,
+            (length > 2) ? data[2] : 0, sent ? "" : " (dropped)");
+    if (!sent) {
+        msgs.dropped++;
+    }
+    if (msgtype == MSGT_I2C_DATA) {
+        msgs.data++;
+    } else if (msgtype == MSGT_I2C_DBG) {
+        // the count, the code and the event count (i2c_slave_errors())
+        msgs.dbg++;
+        if ((length >= 2) && (data[1] >= I2C_ERR_OVERRUN)
+                && (data[1] < I2C_ERR_OVERRUN + NUM_ERRS)) {
+            msgs.errors[data[1] - I2C_ERR_OVERRUN] += data[0];
+        } else {
+            msgs.unknown++;
+        }
+    } else {
+        msgs.other++;
+    }
+}
+
+static sim_host host = {
+    host_now,
+    host_wait,
+    host_at,
+    host_i2c_op,
+    host_i2c_release,
+    host_uart_tx,
+    host_pin,
+    150,
+    200,
+    host_message
+};
+
+//----------------------------------------------------------------------------
+
+static double host_seconds(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (ts.tv_sec + ts.tv_nsec / 1e9);
+}
+
+static void report(const char *lib, unsigned long seed, double khz, double host_time) {
+    double sim_time_s = (double) (now - run.started) / SIM_FOSC;
+    sim_pic_stats s;
+    unsigned long errors = 0;
+    int k;
+
+    nodes[0].pic->stats(&s);
+    printf("%s at %02X, seed %lu: %lu transactions (and %lu probes) at %.0f kHz\n", lib,
+            run.addr, seed, run.done, run.kinds[K_PROBE], khz);
+    printf("    in %.3f s simulated, %.0f a second; %.3f s on the host, %.0f a second\n",
+            sim_time_s, sim_time_s > 0 ? run.done / sim_time_s : 0.0, host_time,
+            host_time > 0 ? run.done / host_time : 0.0);
+    printf("\n%-12s %9s %9s %9s\n", "transaction", "sent", "NACKed", "timed out");
+    for (k = 0; k < NUM_KINDS; k++) {
+        printf("%-12s %9lu %9lu %9lu\n", kind_names[k], run.kinds[k], run.nacks[k],
+                run.timeouts[k]);
+    }
+    printf("\n%lu bytes written and %lu read; the clock held %lu times, %.3f ms in all, "
+            "%.1f us at most, %lu times past %.0f ms\n", run.bytes_written, run.bytes_read,
+            nodes[0].holds, MS(nodes[0].held), US(nodes[0].held_max), clk.overlong,
+            MS(HOLD_LIMIT));
+    if (clk.overlong_reply) {
+        printf("no reply to a read after:");
+        for (k = 0; k < 256; k++) {
+            if (run.no_reply[k]) {
+                printf(" %02X", k);
+            }
+        }
+        printf("\n");
+    }
+    printf("probes: %lu failed of %lu\n", run.probes_failed, run.kinds[K_PROBE]);
+    printf("interrupts: %lu high, %lu low, %lu for SSPIF; SSPOV %lu times\n", s.isr_high,
+            s.isr_low, s.ssp_isrs, s.sspov);
+    printf("    %.1f Tcy charged per I2C event (-i); host CPU ns per SSPIF p50 %lu, p90 %lu, "
+            "p99 %lu\n", s.ssp_isrs ? (double) s.isr_time / SIM_TCY / s.ssp_isrs : 0.0,
+            ns_percentile(&s, 50), ns_percentile(&s, 90), ns_percentile(&s, 99));
+    printf("\nto main(): %lu MSGT_I2C_DATA (for %lu writes with data), %lu MSGT_I2C_DBG, "
+            "%lu others, %lu dropped\n", msgs.data, run.writes_with_data, msgs.dbg, msgs.other,
+            msgs.dropped);
+    for (k = 0; k < NUM_ERRS; k++) {
+        errors += msgs.errors[k];
+    }
+    printf("errors reported: %lu\n", errors);
+    for (k = 0; k < NUM_ERRS; k++) {
+        printf("    %02X %-10s %9lu\n", I2C_ERR_OVERRUN + k, err_names[k], msgs.errors[k]);
+    }
+    if (msgs.unknown) {
+        printf("    (and %lu MSGT_I2C_DBG with no known code)\n", msgs.unknown);
+    }
+    if (s.pool_empty) {
+        printf("sends that found the message pool empty: %lu\n", s.pool_empty);
+    }
+}
+
+static void usage(void) {
+    fprintf(stderr, "usage: stress [-n transactions] [-s seed] [-k kHz] [-g us of gap] "
+            "[-p transactions between probes] [-r] [-a address] [-l lib] [-i cycles per interrupt] "
+            "[-w cycles per pass of main()] [-d dir] [-v]\n");
+    exit(2);
+}
+
+int main(int argc, char **argv) {
+    unsigned long seed = 1;
+    double khz = 400;
+    double gap_us = 50;
+    const char *dir = ".";
+    const char *lib = "SENSORPIC.so";
+    double host_time;
+    int opt;
+
+    run.count = 20000;
+    run.probe_every = 100;
+    run.addr = SENSOR_ADDR;
+    run.last_cmd = NO_CMD;
+    while ((opt = getopt(argc, argv, "n:s:k:g:p:ra:l:i:w:d:v")) != -1) {
+        switch (opt) {
+            case 'n': run.count = strtoul(optarg, 0, 0); break;
+            case 's': seed = strtoul(optarg, 0, 0); break;
+            case 'k': khz = atof(optarg); break;
+            case 'g': gap_us = atof(optarg); break;
+            case 'p': run.probe_every = strtoul(optarg, 0, 0); break;
+            case 'r': run.random_commands = 1; break;
+            case 'a': run.addr = strtoul(optarg, 0, 0) & 0xFE; break;
+            case 'l': lib = optarg; break;
+            case 'i': host.isr_tcy = strtoul(optarg, 0, 0); break;
+            case 'w': host.main_tcy = strtoul(optarg, 0, 0); break;
+            case 'd': dir = optarg; break;
+            case 'v': verbose = 1; break;
+            default: usage();
+        }
+    }
+    if ((khz <= 0) || (gap_us < 0) || !host.isr_tcy) {
+        usage();
+    }
+    rnd_state = seed;
+    run.half_bit = SIM_FOSC / (2 * khz * 1000);
+    run.gap_max = gap_us * SIM_FOSC / 1000000;
+    end = SIM_FOREVER - 1;
+
+    sched_node("stress", dir, "slave", lib, &host);
+    sched_start();
+    // the master starts once the PIC is up
+    run.started = SIM_FOSC / 10;
+    push(run.started, ev_begin, 0, 0, 0);
+
+    host_time = host_seconds();
+    sched_run();
+    host_time = host_seconds() - host_time;
+    report(lib, seed, khz, host_time);
+    // (the PIC is left waiting for the CPU)
+    exit((run.probes_failed || (clk.overlong > clk.overlong_reply)) ? 1 : 0);
+}